@@ -0,0 +1,96 @@
+/*  Radio signal clock - Host (PC) benchmark of the calendar of clock.c
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchCalendar
+    Walks the calendar of the clock module forward from 01.01.1999 to
+    31.12.2100 by shifting the clock in steps of 12 hours, and back again,
+    and checks date, weekday, day of the year and leap year flag of every
+    day against a conversion from a day number. Compares the run time of
+    one day step with the conversion from scratch.
+*/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "clock.h"
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// ****************************************************************************
+// Reference: date from the number of days since 01.01.1970
+// (H. Hinnant, chrono-compatible low-level date algorithms)
+static void civilFromDays(long z, CLOCKDATE *d)
+{   long era, doe, yoe, doy, mp, y;
+
+    z += 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = z - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    y = yoe + era * 400;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    d->day = (char) (doy - (153 * mp + 2) / 5 + 1);
+    d->month = (char) (mp < 10 ? mp + 3 : mp - 9);
+    d->year = (int) (y + (d->month <= 2));
+    d->weekday = (char) ((z - 719468 + 3) % 7 + 1);     // 01.01.1970 was a Thursday
+    d->leapYear = (char) (d->year % 4 == 0 && (d->year % 100 != 0 || d->year % 400 == 0));
+    d->yearDay = (int) (d->month <= 2 ? doy - 305 : doy + 60 + d->leapYear);
+}
+
+static long compare(long days)
+{   CLOCKDATE expected;
+    const CLOCKDATE *date = dateClock();
+
+    civilFromDays(days, &expected);
+    return date->year != expected.year || date->month != expected.month || date->day != expected.day
+        || date->weekday != expected.weekday || date->yearDay != expected.yearDay
+        || date->leapYear != expected.leapYear;
+}
+
+// ****************************************************************************
+int main(void)
+{   const long first = 10592, last = 47846;     // 01.01.1999, 31.12.2100
+    CLOCKDATE d;
+    long days, errors = 0, n;
+    long long t0, tStep, tConvert;
+    volatile int sink = 0;
+
+    setZoneClock(0);                            // UTC, no DST
+    setDateClock(1999, 1, 1, 5);
+    setClock(0, 0, 0, 0);
+    for (days = first; days <= last; days++)    // Forward
+    {   errors += compare(days);
+        shiftClock(720);
+        shiftClock(720);
+    }
+    for (days = last + 1; days > first; days--) // ... and back
+    {   shiftClock(-720);
+        shiftClock(-720);
+        errors += compare(days - 1);
+    }
+    printf("Days checked: %ld, differences: %ld\n", 2 * (last - first + 1), errors);
+
+    t0 = nowNs();
+    for (n = 0; n < 10000000L; n++)
+    {   shiftClock(720);
+        shiftClock(720);
+        sink ^= dateClock()->day;
+    }
+    tStep = nowNs() - t0;
+    t0 = nowNs();
+    for (n = 0; n < 10000000L; n++)
+    {   civilFromDays(first + n % 36500, &d);
+        sink ^= d.day;
+    }
+    tConvert = nowNs() - t0;
+    printf("Day step: %.1f ns, conversion from scratch: %.1f ns\n", tStep / 1e7, tConvert / 1e7);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*  Radio signal clock - Host (PC) benchmark of the DST changeover and leap second
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchChangeover [trials] [BER in %]
+    Runs the clock with the signal of dcf77Gen.c through the changeover to
+    CEST, back to CET and a leap second, from 30 minutes before to 30
+    minutes after the event, with and without acting on the announcement
+    bits (dcf77Announcements in dcf77.c). Reported after the first valid
+    time:
+    - lost:    minute markers without a valid frame
+    - wrong:   minutes in which a wrong time or date was shown
+    - seconds: second ticks which did not show the next second, 23:59:60
+               follows 23:59:59 in the minute with the leap second
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dcf77.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define BEFORE  30                              // Minutes before the event
+#define AFTER   30                              // ... and after
+
+// Events: start of the signal, leap second at the end of this minute or none
+static const struct { const char *name; GENTIME start; GENTIME leap; } events[] =
+{   { "CET -> CEST", { 2018,  3, 25, 7, 1, 30, 0 }, { 0, 0, 0, 0, 0, 0, 0 } },
+    { "CEST -> CET", { 2018, 10, 28, 7, 2, 30, 1 }, { 0, 0, 0, 0, 0, 0, 0 } },
+    { "leap second", { 2017,  1,  1, 7, 0, 29, 0 }, { 2017, 1, 1, 7, 0, 59, 0 } },
+};
+
+// ****************************************************************************
+// Seconds shown on the LCD
+static int secondsShown(void)
+{   return (lcdHost[0][6] - '0') * 10 + lcdHost[0][7] - '0';
+}
+
+// ****************************************************************************
+// Run the clock once through an event
+// Parameter:   event, bit error rate, seed of the random numbers, counters
+//              for the results
+// Returns:     -
+static void runTrial(int e, double ber, unsigned long seed, long *lost, long *wrong, long *seconds)
+{   long tick, sinceMarker = 0;
+    int lastMinute, lastSecond = -1, locked = 0;
+    char lastLED = 0;
+
+    setChangeoverGen(1);
+    setLeapSecondGen(events[e].leap.year ? &events[e].leap : NULL);
+    startGen(&events[e].start, 0);
+    setNoiseGen(ber / 2, ber / 2, seed * 2654435761UL + 1);
+    initHost();
+
+    lastMinute = timeGen()->minute;
+    for (tick = 0; tick < (BEFORE + AFTER) * 6000L; tick++)
+    {   runTicksHost(1);
+        sinceMarker++;
+        if (timeGen()->minute != lastMinute)    // Minute marker
+        {   lastMinute = timeGen()->minute;
+            sinceMarker = 0;
+            if (locked && !(ledsHost & 0x08))
+                (*lost)++;
+        } else if (sinceMarker == 3000)
+        {   if (!locked)
+                locked = (ledsHost & 0x08) && lcdShowsTimeGen();
+            else if (!lcdShowsTimeGen())
+                (*wrong)++;
+        }
+        if ((ledsHost & 0x01) && !lastLED)      // Second tick of the clock module
+        {   if (locked && secondsShown() != (lastSecond + 1) % 60
+                && !(secondsShown() == 60 && lastSecond == 59) && !(secondsShown() == 0 && lastSecond == 60))
+                (*seconds)++;
+            lastSecond = secondsShown();
+        }
+        lastLED = (char) (ledsHost & 0x01);
+    }
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   int trials = argc > 1 ? atoi(argv[1]) : 10;
+    double ber = argc > 2 ? atof(argv[2]) / 100.0 : 0.0;
+    long lost, wrong, seconds;
+    int e, on, n;
+
+    setSignalSourceHost(readPortGen);
+
+    printf("%d trials, BER %.0f%%, %d minutes before and after the event\n", trials, ber * 100, BEFORE);
+    printf("event        announcements   lost  wrong  seconds\n");
+    for (e = 0; e < (int) (sizeof(events) / sizeof(events[0])); e++)
+    {   for (on = 0; on <= 1; on++)
+        {   dcf77Announcements = (char) on;
+            lost = wrong = seconds = 0;
+            for (n = 0; n < trials; n++)
+                runTrial(e, ber, (unsigned long) n + 1, &lost, &wrong, &seconds);
+            printf("%-12s %-13s %6ld %6ld %8ld\n", events[e].name, on ? "on" : "off", lost, wrong, seconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*  Radio signal clock - Host (PC) benchmark of the DCF77 pulse classifier
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchClassify [minutes] [jitter ms]
+    Feeds the edges of the frames of dcf77Gen.c into edgeSignalDCF77() and
+    processEventsDCF77() for receivers with different low pulse lengths, as
+    caused by the AGC of the receiver, and random pulse length jitter.
+    Reports for the fixed windows and the adaptive classifier (dcf77Adaptive
+    in dcf77.c) the percentage of bits classified correctly, wrong and
+    invalid, the mean confidence of the correct and wrong bits and the
+    percentage of valid frames. Voting and prediction are off.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dcf77.h"
+#include "ticker.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+// Receiver models: length of the "0" and "1" pulses in ms
+static const struct { const char *name; int zero, one; } receivers[] =
+{   { "nominal",    100, 200 },
+    { "late +30",   130, 230 },
+    { "late +50",   150, 250 },
+    { "early -30",   70, 170 },
+    { "narrow",     110, 180 },
+};
+
+static unsigned long randomState = 1;
+
+// Random number in -range ... range
+static long randomRange(long range)
+{   randomState = randomState * 1103515245UL + 12345UL;
+    return (long) ((randomState >> 8) % (unsigned long) (2 * range + 1)) - range;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long minutes = argc > 1 ? atol(argv[1]) : 600;
+    int jitterMs = argc > 2 ? atoi(argv[2]) : 20;
+    long jitter = MSEC2TIMER(jitterMs);
+    GENTIME t = { 2017, 1, 9, 1, 12, 31, 0 };
+    char frame[59];
+    unsigned long second = 0, rise;
+    long m, correct, wrong, invalid, frames, confCorrect, confWrong;
+    int r, adaptive, bit;
+    DCF77EVENT event;
+
+    setSignalSourceHost(0);
+    dcf77Voting = 0;
+    dcf77Prediction = 0;
+
+    printf("%ld minutes per receiver, pulse jitter +-%d ms\n", minutes, jitterMs);
+    printf("receiver    classifier  correct   wrong  invalid  confidence  frames\n");
+    for (r = 0; r < (int) (sizeof(receivers) / sizeof(receivers[0])); r++)
+    {   for (adaptive = 0; adaptive <= 1; adaptive++)
+        {   dcf77Adaptive = (char) adaptive;
+            initHost();
+            randomState = 1;
+            correct = wrong = invalid = frames = confCorrect = confWrong = 0;
+            for (m = 0; m < minutes; m++)
+            {   nextMinuteGen(&t);
+                encodeFrameGen(frame, &t);
+                for (bit = 0; bit < 59; bit++, second += MSEC2TIMER(1000))
+                {   event = edgeSignalDCF77(second, 0);         // Falling edge
+                    processEventsDCF77(event, second);
+                    if (event == VALIDMINUTE && (ledsHost & 0x08))
+                        frames++;
+                    if (event == VALIDMINUTE && adaptive)       // Classifier task, see task.c
+                        adaptClassifierDCF77();
+                    rise = second + MSEC2TIMER(frame[bit] ? receivers[r].one : receivers[r].zero)
+                         + randomRange(jitter);
+                    event = edgeSignalDCF77(rise, 1);           // Rising edge
+                    processEventsDCF77(event, rise);
+                    if (event == INVALID)
+                        invalid++;
+                    else if ((event == VALIDONE) == frame[bit])
+                    {   correct++;
+                        confCorrect += dcf77Confidence;
+                    } else
+                    {   wrong++;
+                        confWrong += dcf77Confidence;
+                    }
+                }
+                second += MSEC2TIMER(1000);                     // No pulse in second 59
+            }
+            printf("%-11s %-10s %7.2f%% %6.2f%% %7.2f%%  ", receivers[r].name,
+                   adaptive ? "adaptive" : "fixed", 100.0 * correct / (minutes * 59),
+                   100.0 * wrong / (minutes * 59), 100.0 * invalid / (minutes * 59));
+            if (adaptive)
+                printf("%4.0f / %3.0f", correct ? (double) confCorrect / correct : 0.0,
+                       wrong ? (double) confWrong / wrong : 0.0);
+            else
+                printf("      -    ");
+            printf("  %5.1f%%\n", 100.0 * frames / minutes);
+        }
+    }
+    return 0;
+}
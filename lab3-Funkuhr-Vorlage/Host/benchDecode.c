@@ -0,0 +1,172 @@
+/*  Radio signal clock - Host (PC) microbenchmark of the DCF77 frame decoder
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchDecode [frames]
+    Feeds the frames of dcf77Sim.c as event stream into processEventsDCF77(),
+    without and with multi-frame voting and prediction, and into a copy of the
+    original char buffer decoder (processEventsReference below) and reports the time per
+    frame and per minute marker.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "clock.h"
+#include "zone.h"
+#include "dcf77.h"
+#include "led.h"
+#include "ticker.h"
+#include "halHost.h"
+
+extern long dcf77Data[16];
+extern int dcf77DataMin;
+
+// --- Reference: former decoder with one char per bit ------------------------
+static int refBit = 0;
+static char refBuffer[59];
+static char refError = 1;
+
+static char refSum(int first, int last)
+{   char sum = 0;
+    int i;
+    for (i = first; i <= last; i++)
+        sum += refBuffer[i];
+    return sum;
+}
+
+static void processEventsReference(DCF77EVENT event, unsigned long eventTime)
+{   int minute, hour, day, weekday, month, year;
+
+    (void) eventTime;
+
+    switch (event)
+    {
+    case VALIDSECOND:
+        if (++refBit > 58)
+        {   refBit = 0;
+            refError = 1;
+        }
+        break;
+    case VALIDZERO: refBuffer[refBit] = 0; break;
+    case VALIDONE:  refBuffer[refBit] = 1; break;
+    case VALIDMINUTE:
+        if (refBit != 58 || refSum(21, 28) % 2 || refSum(29, 35) % 2 || refSum(36, 58) % 2)
+        {   refBit = 0;
+            refError = 1;
+            break;
+        }
+        refBit = 0;
+        minute = refBuffer[21] * 1 + refBuffer[22] * 2 + refBuffer[23] * 4 + refBuffer[24] * 8
+               + refBuffer[25] * 10 + refBuffer[26] * 20 + refBuffer[27] * 40;
+        hour = refBuffer[29] * 1 + refBuffer[30] * 2 + refBuffer[31] * 4 + refBuffer[32] * 8
+             + refBuffer[33] * 10 + refBuffer[34] * 20;
+        day = refBuffer[36] * 1 + refBuffer[37] * 2 + refBuffer[38] * 4 + refBuffer[39] * 8
+            + refBuffer[40] * 10 + refBuffer[41] * 20;
+        weekday = refBuffer[42] * 1 + refBuffer[43] * 2 + refBuffer[44] * 4;
+        month = refBuffer[45] * 1 + refBuffer[46] * 2 + refBuffer[47] * 4 + refBuffer[48] * 8
+              + refBuffer[49] * 10;
+        year = refBuffer[50] * 1 + refBuffer[51] * 2 + refBuffer[52] * 4 + refBuffer[53] * 8
+             + refBuffer[54] * 10 + refBuffer[55] * 20 + refBuffer[56] * 40 + refBuffer[57] * 80 + 2000;
+        if (minute > 59 || hour > 23 || day > 31 || day == 0 || weekday > 7 || weekday == 0
+            || month > 12 || month == 0 || year > 2099)
+        {   refError = 1;
+            break;
+        }
+        refError = 0;
+        setDateClock(year, (char) month, (char) day, (char) weekday);
+        setClock((char) hour, (char) minute, 0, localOffsetZone(ZONEDCF77, dateClock(), (char) hour));
+        break;
+    case INVALID:
+        refError = 1;
+        break;
+    default:
+        break;
+    }
+
+    if (refError == 1)
+    {   setLED(0x04);
+        clrLED(0x08);
+    } else
+    {   clrLED(0x04);
+        setLED(0x08);
+    }
+}
+
+// --- Benchmark ---------------------------------------------------------------
+typedef void (*DECODER)(DCF77EVENT event, unsigned long eventTime);
+
+static unsigned long eventTime = 0;             // Time of the events in timer counts
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Feed one frame of dcf77Sim.c, returns the time spent in the minute marker
+static long long runFrame(DECODER decoder, int n)
+{   long long t0;
+    int bit;
+
+    for (bit = 0; bit < 59; bit++)
+    {   if (bit > 0)
+            decoder(VALIDSECOND, eventTime += MSEC2TIMER(1000));
+        decoder((dcf77Data[n * 2 + bit / 32] >> (bit % 32)) & 0x01 ? VALIDONE : VALIDZERO,
+                eventTime + MSEC2TIMER(100));
+    }
+    t0 = nowNs();
+    decoder(VALIDMINUTE, eventTime += MSEC2TIMER(2000));
+    return nowNs() - t0;
+}
+
+static void bench(const char *name, DECODER decoder, long frames, long long overhead)
+{   long long t0, total, marker = 0;
+    long n, bad = 0;
+
+    decoder(VALIDMINUTE, eventTime += MSEC2TIMER(60000));  // Synchronize to the frame start
+    t0 = nowNs();
+    for (n = 0; n < frames; n++)
+    {   marker += runFrame(decoder, (int) (n % dcf77DataMin)) - overhead;
+        if (!(ledsHost & 0x08))
+            bad++;
+    }
+    total = nowNs() - t0;
+    printf("%-10s %8.1f ns/frame  %6.1f ns/marker  %ld invalid frames\n",
+           name, (double) total / frames, (double) marker / frames, bad);
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long frames = argc > 1 ? atol(argv[1]) : 1000000L;
+    long long overhead = 0, t0;
+    int n;
+
+    initHost();
+
+    for (n = 0; n < 1000; n++)                  // Cost of the time measurement itself
+    {   t0 = nowNs();
+        overhead += nowNs() - t0;
+    }
+    overhead /= 1000;
+
+    // Sizes on the HCS12 (int = 2 bytes, long = 4 bytes)
+    printf("Frame state RAM: reference 65 bytes (buffer 59, currentBit 2, ERROR 1, paritySum 1, i 2)\n"
+           "                 streaming 31 bytes (frame 8, received 8, fields 10, currentBit 2, ERROR 1,\n"
+           "                                     frameError 1, parityFlags 1)\n"
+           "                 + voting 27 bytes (bitVotes 19, markerTime 4, markerSecond 4)\n"
+           "                 + prediction 30 bytes (expected 10 + 8, candidate 10, flags 2)\n");
+    bench("reference", processEventsReference, frames, overhead);
+    dcf77Voting = 0;
+    dcf77Prediction = 0;
+    bench("streaming", processEventsDCF77, frames, overhead);
+    dcf77Voting = 1;
+    bench("voting", processEventsDCF77, frames, overhead);
+    dcf77Prediction = 1;                        // The jump back after 8 frames is rejected once
+    bench("prediction", processEventsDCF77, frames, overhead);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*  Radio signal clock - Host (PC) benchmark of the DCF77 glitch filter
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchFilter [minutes]
+    Generates the DCF77 signal of dcf77Gen.c with 1ms resolution and glitches
+    of 1 ... 4ms at different rates, and feeds it to the clock
+    - polled every 10ms by tick10ms() / sampleSignalDCF77(), as without
+      DCF77CAPTURE on the target,
+    - sampled every 1ms or 2ms by filterDCF77(), as with DCF77FILTER.
+    Reports the percentage of valid frames (voting and prediction off) and
+    the glitches rejected by the filter, and the run time of filterDCF77()
+    per sample on this PC.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dcf77.h"
+#include "ticker.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+static char level = 1;                          // Current level of the generated signal
+
+// Signal source polled by tick10ms()
+static char readLevel(void)
+{   return level;
+}
+
+// ****************************************************************************
+// Run the clock with one front end
+// Parameter:   minutes, glitches per second, sample period of the filter in
+//              ms (0: poll every 10ms), pointer to the rejected glitches
+// Returns:     percentage of minute markers with a valid frame
+static double run(long minutes, double glitches, int period, unsigned int *rejected)
+{   GENTIME t = { 2017, 1, 9, 1, 12, 31, 0 };
+    long m, markers = 0, valid = 0;
+    int tick, ms, lastMinute;
+    unsigned long now;                          // Real time, the ticker interrupts less often
+
+    setSignalSourceHost(period ? 0 : readLevel);
+    setStepGen(1);
+    startGen(&t, 30);
+    setNoiseGen(0, 0, 1);
+    setGlitchesGen(glitches, 4);
+    initHost();
+    dcf77Glitches = 0;
+    now = tickerTime;
+
+    for (m = 0; m < minutes; m++)
+    {   lastMinute = timeGen()->minute;
+        for (tick = 0; tick < 6000; tick++)
+        {   for (ms = 1; ms <= 10; ms++)
+            {   level = readPortGen();
+                if (period && ms % period == 0)
+                    filterDCF77((unsigned int) (now + ms * TIMER10MS / 10), level);
+            }
+            runTicksHost(1);
+            now += TIMER10MS;
+            if (timeGen()->minute != lastMinute)
+            {   lastMinute = timeGen()->minute;
+                if (m > 1)                      // Skip the start
+                {   markers++;
+                    valid += (ledsHost & 0x08) != 0;
+                }
+            }
+        }
+    }
+    *rejected = dcf77Glitches;
+    return markers ? 100.0 * valid / markers : 0.0;
+}
+
+// ****************************************************************************
+// Run time of the filter per sample
+static double filterCost(void)
+{   struct timespec t0, t1;
+    long n, samples = 100000000L;
+
+    setSignalSourceHost(0);
+    initHost();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (n = 0; n < samples; n++)               // 100ms Low every second
+        filterDCF77((unsigned int) n, (char) (n % 1000 >= 100));
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return ((double) (t1.tv_sec - t0.tv_sec) * 1e9 + (double) (t1.tv_nsec - t0.tv_nsec)) / samples;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   static const double rates[] = { 0, 0.1, 0.5, 2, 10 };
+    long minutes = argc > 1 ? atol(argv[1]) : 60;
+    unsigned int rejected;
+    double valid;
+    int r;
+
+    dcf77Voting = 0;
+    dcf77Prediction = 0;
+
+    printf("Valid frames in %ld minutes, glitches of 1 ... 4ms, filter length %d samples\n",
+           minutes, dcf77FilterLength);
+    printf("glitches/s   poll 10ms   filter 1ms (rejected)   filter 2ms (rejected)\n");
+    for (r = 0; r < (int) (sizeof(rates) / sizeof(rates[0])); r++)
+    {   valid = run(minutes, rates[r], 0, &rejected);
+        printf("%10.1f  %9.1f%%", rates[r], valid);
+        valid = run(minutes, rates[r], 1, &rejected);
+        printf("  %10.1f%% %10u", valid, rejected);
+        valid = run(minutes, rates[r], 2, &rejected);
+        printf("  %10.1f%% %10u\n", valid, rejected);
+    }
+    printf("filterDCF77(): %.1f ns per sample on this PC\n", filterCost());
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*  Radio signal clock - Host (PC) benchmark of the time and date formatter
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchFormat
+    Checks that formatTime() and formatDate() produce exactly the same strings
+    as the former sprintf() calls for every time of day and every date from
+    1999 to 2099, and compares their run time.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "format.h"
+
+static const char *weekdays[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// ****************************************************************************
+int main(void)
+{   char expected[32], text[32];
+    long errors = 0, calls = 0, n;
+    long long t0, tFormat, tSprintf;
+    int h, m, s, year, month, day;
+    volatile char sink = 0;
+
+    // Byte-identical output
+    for (h = 0; h < 24; h++)
+        for (m = 0; m < 60; m++)
+            for (s = 0; s < 60; s++)
+            {   (void) sprintf(expected, "%02d:%02d:%02d", h, m, s);
+                formatTime(text, (char) h, (char) m, (char) s);
+                errors += strcmp(expected, text) != 0;
+            }
+    for (year = 1999; year <= 2099; year++)
+        for (month = 1; month <= 12; month++)
+            for (day = 1; day <= 31; day++)
+            {   (void) sprintf(expected, "%s%02d.%02d.%04d%s", weekdays[day % 7], day, month, year, year & 1 ? "US" : "EU");
+                formatDate(text, weekdays[day % 7], day, month, year, year & 1 ? "US" : "EU");
+                errors += strcmp(expected, text) != 0;
+            }
+    printf("Output differences: %ld\n", errors);
+
+    // Run time of one time and one date update
+    t0 = nowNs();
+    for (n = 0; n < 1000000L; n++, calls++)
+    {   (void) sprintf(text, "%02d:%02d:%02d", (int) (n % 24), (int) (n % 60), (int) (n % 59));
+        sink ^= text[7];
+        (void) sprintf(text, "%s%02d.%02d.%04d%s", weekdays[n % 7], (int) (n % 31) + 1, (int) (n % 12) + 1, 2000 + (int) (n % 100), "EU");
+        sink ^= text[12];
+    }
+    tSprintf = nowNs() - t0;
+    t0 = nowNs();
+    for (n = 0; n < 1000000L; n++)
+    {   formatTime(text, (char) (n % 24), (char) (n % 60), (char) (n % 59));
+        sink ^= text[7];
+        formatDate(text, weekdays[n % 7], (int) (n % 31) + 1, (int) (n % 12) + 1, 2000 + (int) (n % 100), "EU");
+        sink ^= text[12];
+    }
+    tFormat = nowNs() - t0;
+    printf("sprintf   %6.1f ns per time + date update\n", (double) tSprintf / calls);
+    printf("formatter %6.1f ns per time + date update\n", (double) tFormat / calls);
+    return errors != 0;
+}
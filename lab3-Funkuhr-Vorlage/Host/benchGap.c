@@ -0,0 +1,92 @@
+/*  Radio signal clock - Host (PC) benchmark of long gaps of the signal
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchGap [lock minutes]
+    Receives the signal of dcf77Gen.c, polled every 10ms like on the target,
+    until the votes and the prediction of dcf77.c are built up, then holds it
+    High for a gap and receives it again. The gap starts and ends with a
+    minute, so the first frame after it has an error (the period of its
+    first edge) and is only repaired by the prediction or the votes.
+    The timer counts wrap after 381.8 minutes on the target, processEventsDCF77()
+    masks them to 32 bit on the host, so a gap longer than that is measured
+    modulo the wrap in timer counts. Gaps of more than MAXGAP minutes must
+    drop the votes and the prediction, which would otherwise repair the
+    frame to a wrong minute. Reports for each gap the minutes from its end
+    to the correct time shown and the time a wrong time was shown with LED
+    B.3 (valid time) on. Returns 1, if a wrong time was shown.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define AFTER   5                               // Minutes received after the gap
+
+// Gaps in minutes, around MAXGAP and the wraps of the timer counts
+static const long gaps[] = { 1, 60, 359, 360, 361, 381, 382, 400, 500, 742, 743, 800 };
+
+static char gap = 0;                            // Signal lost, held High
+
+// ****************************************************************************
+// Signal source, the generator keeps running during the gap
+static char readPortGap(void)
+{   char signal = readPortGen();
+
+    return gap ? 1 : signal;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long lock = argc > 1 ? atol(argv[1]) : 10;
+    GENTIME start = { 2017, 1, 9, 1, 12, 31, 0 };
+    long ticks, first, wrong, wrongTicks;
+    int g, failed = 0;
+    char lost;
+
+    setSignalSourceHost(readPortGap);
+
+    printf("Signal for %ld minutes, gap, then %d minutes signal\n", lock, AFTER);
+    printf("   gap  correct after  wrong time shown\n");
+    for (g = 0; g < (int) (sizeof(gaps) / sizeof(gaps[0])); g++)
+    {   startGen(&start, 0);
+        clearEEPROMHost();
+        initHost();
+        runTicksHost(lock * 6000L);
+        gap = 1;
+        runTicksHost(gaps[g] * 6000L);
+        gap = 0;
+
+        first = 0;
+        wrong = wrongTicks = 0;
+        lost = 0;
+        for (ticks = 1; ticks <= AFTER * 6000L; ticks++)
+        {   runTicksHost(1);
+            if ((ledsHost & 0x08) && !lcdShowsTimeGen())
+            {   if (++wrong > 100)              // The time line is updated with
+                    wrongTicks++;               // ... the next second after a frame
+            } else
+            {   wrong = 0;
+                if (!(ledsHost & 0x08))         // The first edge after the gap is invalid
+                    lost = 1;
+                else if (lost && first == 0)
+                    first = ticks;
+            }
+        }
+        failed |= wrongTicks > 0;
+
+        printf("%6ld  ", gaps[g]);
+        if (first)
+            printf("%8.1f min", first / 6000.0);
+        else
+            printf("%12s", "never");
+        printf("  %12.1f s\n", wrongTicks / 100.0);
+    }
+    printf("%s\n", failed ? "FAILED: wrong time shown" : "OK");
+    return failed;
+}
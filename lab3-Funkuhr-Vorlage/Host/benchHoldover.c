@@ -0,0 +1,141 @@
+/*  Radio signal clock - Host (PC) benchmark of the holdover without signal
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchHoldover [learn minutes] [holdover hours]
+    Feeds the edges of the frames of dcf77Gen.c with timestamps via
+    edgeHost() for a crystal with a frequency error, then removes the signal
+    and lets the clock run free. Reports the error of the time shown at the
+    end of the holdover
+    - untrimmed:   without the crystal trim (clockAutoTrim in clock.c),
+    - trimmed:     with the trim learned while the signal was received,
+    - after reset: with the trim read from the EEPROM after a reset, the
+                   signal is only received for 10 minutes after the reset.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "clock.h"
+#include "ticker.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define STEP    MSEC2TIMER(5)                   // Less than a tick, see runUntil()
+#define DAY     86400L
+
+// Crystal frequency errors in ppm
+static const double crystals[] = { 50, -100, 20 };
+
+static const char *variants[] = { "untrimmed", "trimmed", "after reset" };
+
+// Local time in timer counts, 64 bit because tickerTime wraps after 6.4h
+static unsigned long long now, origin;
+static double second;                           // Local timer counts per true second
+static long secondsOrigin;                      // Second of the day at origin
+static double lastError;                        // Error of the last second tick in ms
+
+static GENTIME t;
+static long s;                                  // Seconds sent since origin
+static unsigned long randomState = 1;
+
+// Random number in -1 ... 1
+static double randomJitter(void)
+{   randomState = randomState * 1103515245UL + 12345UL;
+    return (double) ((randomState >> 8) % 20001UL) / 10000.0 - 1.0;
+}
+
+// ****************************************************************************
+// Run the clock up to a point of local time, measure the error of the time
+// shown at every second tick
+// Parameter:   local time in timer counts
+// Returns:     -
+static void runUntil(unsigned long long time)
+{   static char lastLED = 0;
+    unsigned long long tick;
+    double elapsed;
+    long shown, n;
+
+    while (now < time)
+    {   now = time - now > STEP ? now + STEP : time;
+        runUntilHost((unsigned long) now);
+        if ((ledsHost & 0x01) && !lastLED)      // Second tick of the clock module
+        {   tick = now - (unsigned long) ((unsigned long) now - tickerTime);
+            shown = ((lcdHost[0][0] - '0') * 10 + lcdHost[0][1] - '0') * 3600L
+                  + ((lcdHost[0][3] - '0') * 10 + lcdHost[0][4] - '0') * 60L
+                  + (lcdHost[0][6] - '0') * 10 + lcdHost[0][7] - '0';
+            elapsed = (double) (tick - origin) / second;
+            n = shown - secondsOrigin;          // Second shown, in the day nearest to elapsed
+            n += (long) floor((elapsed - n) / DAY + 0.5) * DAY;
+            lastError = ((double) (tick - origin) - n * second) * 1000.0 / TIMERHZ;
+        }
+        lastLED = (char) (ledsHost & 0x01);
+    }
+}
+
+// ****************************************************************************
+// Send the signal for a number of minutes
+static void sendMinutes(long minutes, double jitter)
+{   char frame[59];
+    unsigned long long edge;
+    int bit;
+
+    for (; minutes > 0; minutes--)
+    {   nextMinuteGen(&t);
+        encodeFrameGen(frame, &t);
+        for (bit = 0; bit < 60; bit++, s++)
+        {   if (bit == 59)                      // No pulse in second 59
+                continue;
+            edge = origin + (unsigned long long) (s * second + jitter * (1 + randomJitter()));
+            runUntil(edge);
+            edgeHost((unsigned long) edge, 0);
+            edge += (unsigned long long) (MSEC2TIMER(frame[bit] ? 200 : 100) + jitter * randomJitter());
+            runUntil(edge);
+            edgeHost((unsigned long) edge, 1);
+        }
+    }
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long learn = argc > 1 ? atol(argv[1]) : 240;
+    long hours = argc > 2 ? atol(argv[2]) : 24;
+    GENTIME start = { 2017, 1, 9, 1, 12, 31, 0 };
+    double jitter = MSEC2TIMER(1);
+    int c, v;
+
+    setSignalSourceHost(0);
+
+    printf("Signal for %ld minutes, edge jitter 1ms, then %ld hours holdover\n", learn, hours);
+    printf("crystal  variant        trim    error after holdover\n");
+    for (c = 0; c < (int) (sizeof(crystals) / sizeof(crystals[0])); c++)
+    {   for (v = 0; v < 3; v++)
+        {   clockAutoTrim = (char) (v > 0);
+            clearEEPROMHost();
+            initHost();
+            t = start;
+            randomState = 1;
+            second = TIMERHZ * (1.0 + crystals[c] * 1e-6);
+            now = tickerTime;
+            origin = now + 3456;                // Any phase of the ticks
+            secondsOrigin = start.hour * 3600L + start.minute * 60L;
+            s = 0;
+
+            sendMinutes(learn, jitter);
+            if (v == 2)                         // Reset, then receive a few frames
+            {   initHost();
+                sendMinutes(10, jitter);
+            }
+            s += hours * 3600;                  // Holdover
+            runUntil(origin + (unsigned long long) (s * second));
+
+            printf("%+5.0fppm  %-11s %+7.2fppm  %+10.1f ms\n", crystals[c], variants[v],
+                   clockTrim * 1e6 / 65536.0 / TIMER10MS, lastError);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+/*  Radio signal clock - Host (PC) Monte Carlo benchmark of the time to lock
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchLock [trials] [-j jobs] [-o file] [-m ber jitter glitches fades]
+    Starts the clock many times at random times and seconds with the signal
+    of dcf77Gen.c, polled every 10ms by sampleSignalDCF77() and decoded by
+    processEventsDCF77() like on the target, for a set of noise models:
+    - ber:      bit error rate in %, half of the bad bits flipped, half erased
+    - jitter:   random offset of each edge up to +-ms
+    - glitches: short pulses of the opposite level (up to 20ms) per minute
+    - fades:    signal lost (held High) for 30s on average, per hour
+    Measures the time until the correct time and date are shown first and
+    counts false locks, i.e. a wrong time shown with LED B.3 (valid time) on
+    before. The trials are split between jobs processes (default: one per
+    CPU). initHost() resets all modules, so every trial depends only on its
+    number and the results do not depend on the number of jobs. -m runs a
+    single noise model instead of the built-in table, -o appends one JSON
+    line per noise model to a file.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "dcf77.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define MAXMINUTES  120                         // Give up after 2 hours
+#define TIMEOUT     (MAXMINUTES * 6000L + 1)    // Sorts after all locks
+#define GLITCHMAX   20                          // Maximum glitch length in ms
+#define FADELENGTH  30                          // Mean fade length in seconds
+
+typedef struct
+{   const char *name;
+    double ber;                                 // Bit error rate in %
+    int jitter;                                 // Edge jitter +-ms
+    double glitches;                            // Glitches per minute
+    double fades;                               // Fades per hour
+} NOISEMODEL;
+
+// Noise models, can be replaced by -m
+static NOISEMODEL models[] =
+{   { "clean",    0,  0, 0,  0 },
+    { "ber5",     5,  0, 0,  0 },
+    { "ber15",   15,  0, 0,  0 },
+    { "jitter30", 0, 30, 0,  0 },
+    { "glitch",   0,  0, 6,  0 },
+    { "fading",   0,  0, 0, 10 },
+    { "mixed",    5, 20, 2,  4 },
+};
+
+typedef struct
+{   int trial;
+    long ticks;                                 // Time to lock in 10ms ticks, TIMEOUT if none
+    long falseTicks;                            // ... to the first false lock, 0 if none
+} RESULT;
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// ****************************************************************************
+// Start the clock once and wait for the correct time
+// Parameter:   noise model, number of the trial, result
+// Returns:     -
+static void runTrial(const NOISEMODEL *model, int trial, RESULT *result)
+{   GENTIME t = { 2017, 1, 9, 1, 12, 31, 0 };
+    unsigned long seed = (unsigned long) trial + 1;
+    long minutes = (long) (seed * 7919 % (24 * 60)), ticks;
+    int wrong = 0;
+
+    for (; minutes > 0; minutes--)              // Random start time and second
+        nextMinuteGen(&t);
+    startGen(&t, (int) (seed % 60));
+    setNoiseGen(model->ber / 200, model->ber / 200, seed * 2654435761UL + 1);
+    setJitterGen(model->jitter);
+    setGlitchesGen(model->glitches / 60, GLITCHMAX);
+    setFadingGen(model->fades, FADELENGTH);
+    clearEEPROMHost();
+    initHost();
+
+    result->trial = trial;
+    result->ticks = TIMEOUT;
+    result->falseTicks = 0;
+    for (ticks = 1; ticks <= MAXMINUTES * 6000L; ticks++)
+    {   runTicksHost(1);
+        if (ledsHost & 0x08)
+        {   if (lcdShowsTimeGen())
+            {   result->ticks = ticks;
+                return;
+            }
+            if (++wrong > 100 && result->falseTicks == 0)  // The time line is updated with
+                result->falseTicks = ticks;             // ... the next second after a frame
+        } else
+            wrong = 0;
+    }
+}
+
+static int compareLong(const void *a, const void *b)
+{   long x = *(const long *) a, y = *(const long *) b;
+    return (x > y) - (x < y);
+}
+
+// ****************************************************************************
+// Percentile of sorted times in minutes, -1 for a time out
+static double percentile(const long *times, int count, int percent)
+{   long t;
+
+    if (count == 0)
+        return -1;
+    t = times[(count - 1) * percent / 100];
+    return t == TIMEOUT ? -1 : t / 6000.0;
+}
+
+// ****************************************************************************
+// Print a percentile of the time to lock in minutes
+static void printPercentile(double minutes)
+{   if (minutes < 0)
+        printf("  >%4d", MAXMINUTES);
+    else
+        printf("  %5.1f", minutes);
+}
+
+// ****************************************************************************
+// Run all trials of a noise model in jobs processes
+// Parameter:   noise model, trials, jobs, results sorted by trial
+// Returns:     0 if all jobs succeeded
+static int runModel(const NOISEMODEL *model, int trials, int jobs, RESULT *results)
+{   RESULT result;
+    int job, n, fd[2], status = 0;
+    pid_t pid;
+
+    if (pipe(fd) != 0)
+        return 1;
+    for (job = 0; job < jobs; job++)
+    {   if ((pid = fork()) == 0)
+        {   close(fd[0]);
+            for (n = job; n < trials; n += jobs)
+            {   runTrial(model, n, &result);
+                if (write(fd[1], &result, sizeof(result)) != sizeof(result))
+                    _exit(1);
+            }
+            _exit(0);
+        } else if (pid < 0)
+            return 1;
+    }
+    close(fd[1]);
+    for (n = 0; n < trials; n++)
+    {   if (read(fd[0], &result, sizeof(result)) != sizeof(result))
+        {   status = 1;
+            break;
+        }
+        results[result.trial] = result;
+    }
+    close(fd[0]);
+    while (wait(NULL) > 0)
+        ;
+    return status;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   int trials = 200, jobs = (int) sysconf(_SC_NPROCESSORS_ONLN), modelCount = sizeof(models) / sizeof(models[0]);
+    const char *fileName = NULL;
+    FILE *file = NULL;
+    RESULT *results;
+    long *times, *falseTimes;
+    int m, n, timeouts, falseLocks;
+    double seconds, p[3];
+    long long t0;
+
+    for (n = 1; n < argc; n++)
+    {   if (strcmp(argv[n], "-j") == 0 && n + 1 < argc)
+            jobs = atoi(argv[++n]);
+        else if (strcmp(argv[n], "-o") == 0 && n + 1 < argc)
+            fileName = argv[++n];
+        else if (strcmp(argv[n], "-m") == 0 && n + 4 < argc)
+        {   models[0].name = "custom";
+            models[0].ber = atof(argv[++n]);
+            models[0].jitter = atoi(argv[++n]);
+            models[0].glitches = atof(argv[++n]);
+            models[0].fades = atof(argv[++n]);
+            modelCount = 1;
+        } else
+            trials = atoi(argv[n]);
+    }
+    if (trials < 1)
+        trials = 1;
+    if (jobs < 1)
+        jobs = 1;
+    if (jobs > trials)
+        jobs = trials;
+    if (fileName && (file = fopen(fileName, "a")) == NULL)
+    {   fprintf(stderr, "Cannot open %s\n", fileName);
+        return 1;
+    }
+    results = malloc(trials * sizeof(RESULT));
+    times = malloc(trials * sizeof(long));
+    falseTimes = malloc(trials * sizeof(long));
+    setSignalSourceHost(readPortGen);
+
+    printf("Time to the first correct time in minutes, %d trials each, %d jobs\n", trials, jobs);
+    printf("model     BER  jitter  glitch/min  fades/h  median    p90    p99  timeouts  false locks  (median)\n");
+    for (m = 0; m < modelCount; m++)
+    {   t0 = nowNs();
+        if (runModel(&models[m], trials, jobs, results) != 0)
+        {   fprintf(stderr, "Job failed\n");
+            return 1;
+        }
+        seconds = (nowNs() - t0) * 1e-9;
+        timeouts = falseLocks = 0;
+        for (n = 0; n < trials; n++)
+        {   times[n] = results[n].ticks;
+            timeouts += results[n].ticks == TIMEOUT;
+            if (results[n].falseTicks)
+                falseTimes[falseLocks++] = results[n].falseTicks;
+        }
+        qsort(times, trials, sizeof(long), compareLong);
+        qsort(falseTimes, falseLocks, sizeof(long), compareLong);
+        p[0] = percentile(times, trials, 50);
+        p[1] = percentile(times, trials, 90);
+        p[2] = percentile(times, trials, 99);
+
+        printf("%-8s %3.0f%%  %4dms  %10.1f  %7.1f", models[m].name, models[m].ber, models[m].jitter,
+               models[m].glitches, models[m].fades);
+        printPercentile(p[0]);
+        printPercentile(p[1]);
+        printPercentile(p[2]);
+        printf("  %8d  %10.1f%%", timeouts, 100.0 * falseLocks / trials);
+        if (falseLocks)
+            printPercentile(percentile(falseTimes, falseLocks, 50));
+        printf("\n");
+
+        if (file)                               // -1 stands for a time out
+            fprintf(file, "{\"model\":\"%s\",\"ber\":%g,\"jitter\":%d,\"glitches\":%g,\"fades\":%g,"
+                    "\"trials\":%d,\"p50\":%.2f,\"p90\":%.2f,\"p99\":%.2f,\"timeouts\":%d,"
+                    "\"falseLocks\":%d,\"falseLockPercent\":%.2f,\"falseP50\":%.2f,\"seconds\":%.2f}\n",
+                    models[m].name, models[m].ber, models[m].jitter, models[m].glitches, models[m].fades,
+                    trials, p[0], p[1], p[2], timeouts, falseLocks, 100.0 * falseLocks / trials,
+                    percentile(falseTimes, falseLocks, 50), seconds);
+    }
+    if (file)
+        fclose(file);
+    free(results);
+    free(times);
+    free(falseTimes);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*  Radio signal clock - Host (PC) benchmark of the software PLL
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchPhase [minutes]
+    Feeds the edges of the frames of dcf77Gen.c with timestamps via
+    edgeHost(), like the input capture on the target, for a crystal with
+    a frequency error and a receiver with random edge jitter. At every
+    second tick of the clock module the phase error to the true DCF77
+    second is measured. Reports with and without the software PLL and the
+    crystal trim (clockPLL, clockAutoTrim in clock.c) the mean, RMS and maximum phase error and the
+    number of seconds, which were not shown in sequence. The first 5
+    minutes are skipped.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "clock.h"
+#include "dcf77.h"
+#include "ticker.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define SKIP    5                               // Minutes before measuring
+
+// Scenarios: frequency error of the crystal in ppm, edge jitter in ms
+static const struct { double ppm; double jitter; } scenarios[] =
+{   {    0, 0 },
+    {   50, 0 },
+    { -100, 0 },
+    {   50, 1 },
+    {   50, 3 },
+};
+
+static unsigned long randomState = 1;
+
+// Random number in -1 ... 1
+static double randomJitter(void)
+{   randomState = randomState * 1103515245UL + 12345UL;
+    return (double) ((randomState >> 8) % 20001UL) / 10000.0 - 1.0;
+}
+
+// Phase statistics of one run
+static double sum, sumSquares, maximum;
+static long count, jumps;
+
+// ****************************************************************************
+// Run the clock up to a point of local time in steps of 1ms, measure the
+// phase error at every second tick
+// Parameter:   local time in timer counts, local time of second 0 and length
+//              of a true second in local timer counts
+// Returns:     -
+static void runUntil(unsigned long time, unsigned long origin, double second)
+{   static char lastLED = 0, lastSecond = -1;
+    unsigned long t = tickerTime;
+    double error;
+    char sec;
+
+    do
+    {   t = (long) (time - t) > (long) MSEC2TIMER(1) ? t + MSEC2TIMER(1) : time;
+        runUntilHost(t);
+        if ((ledsHost & 0x01) && !lastLED)      // Second tick of the clock module
+        {   error = fmod((double) (tickerTime - origin), second);
+            if (error > second / 2)
+                error -= second;
+            error = error * 1000.0 / TIMERHZ;
+            sec = (char) ((lcdHost[0][6] - '0') * 10 + lcdHost[0][7] - '0');
+            if ((double) (tickerTime - origin) > SKIP * 60 * second)
+            {   sum += fabs(error);
+                sumSquares += error * error;
+                if (fabs(error) > maximum)
+                    maximum = fabs(error);
+                count++;
+                if (sec != (lastSecond + 1) % 60)
+                    jumps++;
+            }
+            lastSecond = sec;
+        }
+        lastLED = (char) (ledsHost & 0x01);
+    } while (t != time);
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long minutes = argc > 1 ? atol(argv[1]) : 60;
+    GENTIME t;
+    char frame[59];
+    unsigned long origin, fall;
+    double second, jitter;
+    long m, s;
+    int n, pll, bit;
+
+    setSignalSourceHost(0);
+
+    printf("%ld minutes, phase error of the second tick in ms\n", minutes);
+    printf("crystal  jitter   PLL     mean     rms     max  jumps  locked\n");
+    for (n = 0; n < (int) (sizeof(scenarios) / sizeof(scenarios[0])); n++)
+    {   for (pll = 0; pll <= 1; pll++)
+        {   GENTIME start = { 2017, 1, 9, 1, 12, 31, 0 };
+
+            clockPLL = (char) pll;
+            clockAutoTrim = (char) pll;
+            clearEEPROMHost();
+            initHost();
+            t = start;
+            randomState = 1;
+            sum = sumSquares = maximum = 0;
+            count = jumps = 0;
+            second = TIMERHZ * (1.0 + scenarios[n].ppm * 1e-6);
+            jitter = MSEC2TIMER(1) * scenarios[n].jitter;
+            origin = tickerTime + 3456;         // Any phase of the ticks
+            for (m = 0, s = 0; m < minutes; m++)
+            {   nextMinuteGen(&t);
+                encodeFrameGen(frame, &t);
+                for (bit = 0; bit < 60; bit++, s++)
+                {   if (bit == 59)              // No pulse in second 59
+                        continue;
+                    fall = origin + (long) (s * second + jitter * randomJitter());
+                    runUntil(fall, origin, second);
+                    edgeHost(fall, 0);
+                    fall += (long) (MSEC2TIMER(frame[bit] ? 200 : 100) + jitter * randomJitter());
+                    runUntil(fall, origin, second);
+                    edgeHost(fall, 1);
+                }
+            }
+            runUntil(origin + (unsigned long) (s * second), origin, second);
+            printf("%+5.0fppm  %4.1fms  %-4s %7.3f %7.3f %7.3f  %5ld  %5us\n", scenarios[n].ppm,
+                   scenarios[n].jitter, pll ? "on" : "off", count ? sum / count : 0.0,
+                   count ? sqrt(sumSquares / count) : 0.0, maximum, jumps, clockLocked);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,234 @@
+/*  Radio signal clock - Host (PC) round trip of every minute from 2000 to 2099
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchRoundTrip [first year] [last year] [-s] [-j jobs]
+    Encodes the frame of every minute from 01.01.<first> 00:00 to
+    31.12.<last> 23:59 of the time transmitted (CET or CEST, following the
+    EU DST rule) with encodeUTCGen() of dcf77Gen.c, turns it into the pulses
+    of the signal, samples them with sampleSignalDCF77(), decodes them with
+    processEventsDCF77() and checks the time and date the clock module takes
+    over after each minute marker: time shown, year, month, day, weekday,
+    day of the year and leap year flag.
+    sampleSignalDCF77() only acts on a change of the signal, so by default
+    it is only called for the samples with an edge. With -s it is called for
+    every sample, i.e. 6000 times per minute like tick10ms() does.
+    The years are split between jobs processes (default: one per CPU), each
+    starts 3 minutes before its first minute to synchronize the decoder.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "clock.h"
+#include "dcf77.h"
+#include "ticker.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define WARMUP      3                           // Minutes before the first minute checked
+#define MAXREPORTS  3                           // Errors printed per job
+
+typedef struct
+{   long minutes;                               // Minutes checked
+    long invalid;                               // ... without a valid frame
+    long wrong;                                 // ... with a wrong time or date
+    long samples;                               // Calls of sampleSignalDCF77()
+} RESULT;
+
+static unsigned long ms;                        // Time of the signal
+static long samples;
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+static int leapYear(int year)
+{   return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+// ****************************************************************************
+// Sample the signal and decode the event, if any
+static void sample(unsigned long time, char level)
+{   DCF77EVENT event;
+
+    levelHost(level);
+    event = sampleSignalDCF77((int) time);
+    samples++;
+    if (event != NODCF77EVENT)
+        processEventsDCF77(event, MSEC2TIMER(time));
+    if (event == VALIDMINUTE && dcf77Adaptive)  // Classifier task, see task.c
+        adaptClassifierDCF77();
+}
+
+// ****************************************************************************
+// Send the pulses of one frame, starting with the falling edge of second 1
+// Parameter:   frame, 1 to sample every 10ms, else only on the edges
+// Returns:     -
+// Note:        The falling edge of second 0 is the minute marker, it is sent
+//              by markerRoundTrip() before.
+static void frameRoundTrip(const char frame[59], int allSamples)
+{   int s, n, pulse;
+
+    for (s = 0; s < 60; s++)
+    {   pulse = s < 59 ? (frame[s] ? 20 : 10) : 0;  // Low samples of this second
+        if (allSamples)
+        {   for (n = s == 0; n < 100; n++)
+                sample(ms + s * 1000UL + n * 10UL, (char) (n >= pulse));
+        } else if (s < 59)
+        {   if (s > 0)
+                sample(ms + s * 1000UL, 0);
+            sample(ms + s * 1000UL + pulse * 10UL, 1);
+        }
+    }
+    ms += 60000UL;
+}
+
+// ****************************************************************************
+// Compare the time and date taken over by the clock module with a time
+// Returns:     0 if equal, 1 if the frame was invalid, 2 if wrong
+static int checkRoundTrip(const GENTIME *t)
+{   static const int monthStart[13] = { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+    const CLOCKDATE *date = dateClock();
+    char expected[6];
+
+    if (!(ledsHost & 0x08))
+        return 1;
+    displayTimeClock();
+    sprintf(expected, "%02d:%02d", t->hour, t->minute);
+    if (strncmp(lcdHost[0], expected, 5) != 0 || date->year != t->year || date->month != t->month
+        || date->day != t->day || date->weekday != t->weekday || date->leapYear != leapYear(t->year)
+        || date->yearDay != monthStart[t->month] + t->day + (t->month > 2 && leapYear(t->year)))
+        return 2;
+    return 0;
+}
+
+// ****************************************************************************
+// Run all minutes of some years through the encoder and decoder
+// Parameter:   first and last year of the time transmitted, 1 to sample
+//              every 10ms, results
+// Returns:     -
+static void runYears(int first, int last, int allSamples, RESULT *result)
+{   GENTIME utc, local, previous;
+    char frame[59];
+    int year, days = 0, check, reports = 0;
+    long minute;
+
+    for (year = 2000; year < first; year++)     // 01.01.2000 was a Saturday
+        days += 365 + leapYear(year);
+    for (year = first; year < 2000; year++)
+        days -= 365 + leapYear(year);
+    utc.year = first - 1;                       // 31.12. 23:00 UTC is 01.01. 00:00 CET
+    utc.month = 12;
+    utc.day = 31;
+    utc.weekday = ((days + 4) % 7 + 7) % 7 + 1;
+    utc.hour = 22;
+    utc.minute = 60 - WARMUP;
+    utc.summer = 0;
+
+    previous = utc;
+    memset(result, 0, sizeof(*result));
+    ms = 0;
+    samples = 0;
+    initHost();
+    setSignalSourceHost(0);
+    sample(ms, 1);
+    for (minute = 0; ; minute++)
+    {   encodeUTCGen(frame, &local, &utc);      // Frame sent before the marker of this minute
+        if (minute > 0)                         // Marker of the previous frame
+        {   sample(ms, 0);
+            if (minute > WARMUP)
+            {   result->minutes++;
+                if ((check = checkRoundTrip(&previous)) != 0)
+                {   if (check == 1)
+                        result->invalid++;
+                    else
+                        result->wrong++;
+                    if (reports++ < MAXREPORTS)
+                        fprintf(stderr, "%02d.%02d.%04d %02d:%02d %s: %s |%s|\n", previous.day, previous.month,
+                                previous.year, previous.hour, previous.minute, previous.summer ? "CEST" : "CET",
+                                check == 1 ? "invalid" : "shows", lcdHost[0]);
+                }
+            }
+        }
+        if (local.year > last)
+            break;
+        frameRoundTrip(frame, allSamples);
+        previous = local;
+        nextMinuteGen(&utc);
+    }
+    result->samples = samples;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   int first = 2000, last = 2099, allSamples = 0, jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int n, years, job, start, fd[2];
+    RESULT result, total;
+    long long t0;
+    double seconds;
+    pid_t pid;
+
+    for (n = 1, years = 0; n < argc; n++)
+    {   if (strcmp(argv[n], "-s") == 0)
+            allSamples = 1;
+        else if (strcmp(argv[n], "-j") == 0 && n + 1 < argc)
+            jobs = atoi(argv[++n]);
+        else if (years++ == 0)
+            first = last = atoi(argv[n]);
+        else
+            last = atoi(argv[n]);
+    }
+    years = last - first + 1;
+    if (jobs < 1)
+        jobs = 1;
+    if (jobs > years)
+        jobs = years;
+
+    printf("%d ... %d, %d jobs, sampleSignalDCF77() called %s\n", first, last, jobs,
+           allSamples ? "every 10ms" : "on the edges");
+    if (pipe(fd) != 0)
+        return 1;
+    t0 = nowNs();
+    for (job = 0, start = first; job < jobs; job++)
+    {   n = years / jobs + (job < years % jobs);  // Years of this job
+        if ((pid = fork()) == 0)
+        {   close(fd[0]);
+            runYears(start, start + n - 1, allSamples, &result);
+            if (write(fd[1], &result, sizeof(result)) != sizeof(result))
+                _exit(1);
+            _exit(0);
+        } else if (pid < 0)
+            return 1;
+        start += n;
+    }
+    close(fd[1]);
+    memset(&total, 0, sizeof(total));
+    for (job = 0; job < jobs; job++)
+    {   if (read(fd[0], &result, sizeof(result)) != sizeof(result))
+        {   fprintf(stderr, "Job failed\n");
+            return 1;
+        }
+        total.minutes += result.minutes;
+        total.invalid += result.invalid;
+        total.wrong += result.wrong;
+        total.samples += result.samples;
+    }
+    while (wait(NULL) > 0)
+        ;
+    seconds = (nowNs() - t0) * 1e-9;
+
+    printf("Minutes: %ld, invalid: %ld, wrong: %ld\n", total.minutes, total.invalid, total.wrong);
+    printf("%.1f s, %.0f minutes/s, %.1f us per minute and job, %.0f samples/s\n", seconds,
+           total.minutes / seconds, seconds * jobs * 1e6 / total.minutes, total.samples / seconds);
+    return total.invalid + total.wrong != 0;
+}
@@ -0,0 +1,120 @@
+/*  Radio signal clock - Host (PC) benchmark of the DCF77 decoder in operation
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchTracking [trials] [hours]
+    Starts the clock with the signal of dcf77Gen.c, waits for the correct
+    time and then keeps it running for some hours with a disturbed signal
+    (half of the bad bits flipped, half erased), which drops out completely
+    for 15 minutes every 2 hours. Reported per decoder variant:
+    - valid:    percentage of minute markers with a valid frame
+    - wrong:    minutes in which a wrong time or date was shown
+    - recovery: mean time from the end of a dropout to the next valid frame
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dcf77.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define PERIOD      120                         // Dropout every 120 minutes
+#define DROPOUT     15                          // ... for 15 minutes
+
+static int dropout = 0;                         // Signal lost
+
+// ****************************************************************************
+// Signal source with dropouts, the generator keeps running
+static char readPortDropout(void)
+{   char signal = readPortGen();
+
+    return dropout ? 1 : signal;
+}
+
+// ****************************************************************************
+// Run the clock once
+// Parameter:   bit error rate, seed of the random numbers, hours,
+//              counters for the results
+// Returns:     0 if the clock never showed the correct time
+static int runTrial(double ber, unsigned long seed, int hours,
+                    long *markers, long *valid, long *wrong, long *recovered, long *recovery)
+{   GENTIME t = { 2017, 1, 9, 1, 12, 31, 0 };
+    long minutes = (long) (seed * 7919 % (24 * 60)), m, recoveryStart = -1;
+    int tick, lastMinute;
+
+    for (; minutes > 0; minutes--)              // Random start time and second
+        nextMinuteGen(&t);
+    startGen(&t, (int) (seed % 60));
+    setNoiseGen(0, 0, 1);
+    dropout = 0;
+    initHost();
+
+    for (m = 0; !((ledsHost & 0x08) && lcdShowsTimeGen()); m++)
+    {   if (m > 60L * 6000)                     // Wait for the first valid time
+            return 0;
+        runTicksHost(1);
+    }
+
+    setNoiseGen(ber / 2, ber / 2, seed * 2654435761UL + 1);
+    for (m = 0; m < hours * 60L; m++)
+    {   dropout = m % PERIOD >= PERIOD - DROPOUT;
+        if (m % PERIOD == 0 && m > 0)
+            recoveryStart = m;
+        lastMinute = timeGen()->minute;
+        for (tick = 0; tick < 6000; tick++)
+        {   runTicksHost(1);
+            if (timeGen()->minute != lastMinute)    // Minute marker
+            {   lastMinute = timeGen()->minute;
+                (*markers)++;
+                if (ledsHost & 0x08)
+                {   (*valid)++;
+                    if (recoveryStart >= 0)
+                    {   *recovery += m - recoveryStart;
+                        (*recovered)++;
+                        recoveryStart = -1;
+                    }
+                }
+            } else if (tick == 3000 && !lcdShowsTimeGen())
+                (*wrong)++;
+        }
+    }
+    return 1;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   static const int rates[] = { 10, 20, 30 };
+    static const char *names[4] = { "single", "prediction", "voting", "both" };
+    int trials = argc > 1 ? atoi(argv[1]) : 10;
+    int hours = argc > 2 ? atoi(argv[2]) : 6;
+    long markers, valid, wrong, recovered, recovery;
+    int r, variant, n, failed;
+
+    setSignalSourceHost(readPortDropout);
+
+    printf("%d trials of %d hours each\n", trials, hours);
+    printf("BER  decoder      valid   wrong  recovery  no lock\n");
+    for (r = 0; r < (int) (sizeof(rates) / sizeof(rates[0])); r++)
+    {   for (variant = 0; variant < 4; variant++)
+        {   dcf77Prediction = (char) (variant & 1);
+            dcf77Voting = (char) (variant >> 1);
+            markers = valid = wrong = recovered = recovery = 0;
+            failed = 0;
+            for (n = 0; n < trials; n++)
+                failed += !runTrial(rates[r] / 100.0, (unsigned long) n + 1, hours,
+                                    &markers, &valid, &wrong, &recovered, &recovery);
+            printf("%2d%%  %-10s %6.1f%%  %6ld  ", rates[r], names[variant],
+                   markers ? 100.0 * valid / markers : 0.0, wrong);
+            if (recovered)
+                printf("%6.1f m", (double) recovery / recovered);
+            else
+                printf("     - m");
+            printf("  %7d\n", failed);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*  Radio signal clock - Host (PC) benchmark of the multi-frame voting
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchVoting [trials]
+    Starts the clock many times at random times with the signal of
+    dcf77Gen.c, disturbed with a bit error rate of 0..20% (half of the bad
+    bits flipped, half erased), and measures the time until the correct time
+    and date are shown first, with and without dcf77Voting. A false lock is a
+    wrong time shown with LED B.3 (valid time) on.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dcf77.h"
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+#define MAXMINUTES  120                         // Give up after 2 hours
+
+// ****************************************************************************
+// Start the clock once and wait for the correct time
+// Parameter:   bit error rate, seed of the random numbers, flag for false lock
+// Returns:     time to the correct time in 10ms ticks, -1 on time out
+static long runTrial(double ber, unsigned long seed, int *falseLock)
+{   GENTIME t = { 2017, 1, 9, 1, 12, 31, 0 };
+    long minutes = (long) (seed * 7919 % (24 * 60)), ticks;
+    int wrong = 0;
+
+    for (; minutes > 0; minutes--)              // Random start time and second
+        nextMinuteGen(&t);
+    startGen(&t, (int) (seed % 60));
+    setNoiseGen(ber / 2, ber / 2, seed * 2654435761UL + 1);
+    initHost();
+
+    *falseLock = 0;
+    for (ticks = 1; ticks <= MAXMINUTES * 6000L; ticks++)
+    {   runTicksHost(1);
+        if (ledsHost & 0x08)
+        {   if (lcdShowsTimeGen())
+                return ticks;
+            if (++wrong > 100)                  // The time line is updated with the
+                *falseLock = 1;                 // ... next second after a new frame
+        } else
+            wrong = 0;
+    }
+    return -1;
+}
+
+static int compareLong(const void *a, const void *b)
+{   long x = *(const long *) a, y = *(const long *) b;
+    return (x > y) - (x < y);
+}
+
+// ****************************************************************************
+// Print a percentile of the time to lock in minutes, time outs sort last
+static void printPercentile(long *times, int trials, int percent)
+{   long t = times[(trials - 1) * percent / 100];
+
+    if (t == MAXMINUTES * 6000L + 1)
+        printf("  >%4d", MAXMINUTES);
+    else
+        printf("  %5.1f", t / 6000.0);
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   static const int rates[] = { 0, 5, 10, 15, 20 };
+    int trials = argc > 1 ? atoi(argv[1]) : 200;
+    long *times;
+    int r, voting, n, timeouts, falseLocks, falseLock;
+
+    if (trials < 1)
+        trials = 1;
+    times = malloc(trials * sizeof(long));
+    setSignalSourceHost(readPortGen);
+
+    printf("Time to the first correct time in minutes, %d trials each\n", trials);
+    printf("BER  decoder    median    p90    p99  timeouts  false locks\n");
+    for (r = 0; r < (int) (sizeof(rates) / sizeof(rates[0])); r++)
+    {   for (voting = 0; voting <= 1; voting++)
+        {   dcf77Voting = (char) voting;
+            timeouts = falseLocks = 0;
+            for (n = 0; n < trials; n++)
+            {   times[n] = runTrial(rates[r] / 100.0, (unsigned long) n + 1, &falseLock);
+                if (times[n] < 0)
+                {   times[n] = MAXMINUTES * 6000L + 1;
+                    timeouts++;
+                }
+                falseLocks += falseLock;
+            }
+            qsort(times, trials, sizeof(long), compareLong);
+            printf("%2d%%  %-8s", rates[r], voting ? "voting" : "single");
+            printPercentile(times, trials, 50);
+            printPercentile(times, trials, 90);
+            printPercentile(times, trials, 99);
+            printf("  %8d  %11d\n", timeouts, falseLocks);
+        }
+    }
+    free(times);
+    return 0;
+}
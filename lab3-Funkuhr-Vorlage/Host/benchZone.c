@@ -0,0 +1,89 @@
+/*  Radio signal clock - Host (PC) benchmark of the time zones of zone.c
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: benchZone [years]
+    Runs the clock module second by second from 01.01.2021 00:00 UTC in
+    every zone of the table of zone.c and compares the time and date shown
+    once per minute with localtime() of the C library for the same zone,
+    given as POSIX TZ string. Reports the differences, the run time of a
+    second tick, which includes the DST check on full UTC hours, and of a
+    zone switch. The display itself does no conversion.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "clock.h"
+#include "zone.h"
+#include "halHost.h"
+
+// POSIX TZ strings of the zones of zone.c, in the same order
+static const char *tzStrings[NZONES] =
+{   "UTC0", "GMT0BST,M3.5.0/1,M10.5.0", "CET-1CEST,M3.5.0,M10.5.0/3", "EET-2EEST,M3.5.0/3,M10.5.0/4",
+    "EST5EDT,M3.2.0,M11.1.0", "CST6CDT,M3.2.0,M11.1.0", "MST7MDT,M3.2.0,M11.1.0",
+    "PST8PDT,M3.2.0,M11.1.0", "IST-5:30", "JST-9", "AEST-10AEDT,M10.1.0,M4.1.0/3"
+};
+
+static long long nowNs(void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Time and date shown by the clock against the local time of the C library
+static long compare(time_t t)
+{   const CLOCKDATE *date = dateClock();
+    struct tm tm;
+    char expected[9];
+
+    localtime_r(&t, &tm);
+    displayTimeClock();
+    sprintf(expected, "%02d:%02d:%02d", tm.tm_hour, tm.tm_min, tm.tm_sec);
+    return strncmp(lcdHost[0], expected, 8) != 0 || date->year != tm.tm_year + 1900
+        || date->month != tm.tm_mon + 1 || date->day != tm.tm_mday
+        || date->weekday != (tm.tm_wday == 0 ? 7 : tm.tm_wday) || date->yearDay != tm.tm_yday + 1;
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   const time_t first = 1609459200;            // 01.01.2021 00:00 UTC, a Friday
+    long years = argc > 1 ? atol(argv[1]) : 4;
+    time_t t, last = first + (time_t) (years * 365.2425 * 86400);
+    long errors, ticks = 0, n;
+    long long tTicks = 0, t0;
+    int z;
+
+    initHost();
+    printf("%ld years from 01.01.2021, time and date shown checked every minute\n", years);
+    printf("zone  minutes   differences\n");
+    for (z = 0; z < NZONES; z++)
+    {   setenv("TZ", tzStrings[z], 1);
+        tzset();
+        setZoneClock((char) z);
+        setDateClock(2021, 1, 1, 5);
+        setClock(0, 0, 0, 0);
+        errors = compare(first);
+        for (t = first + 60; t < last; t += 60)
+        {   t0 = nowNs();
+            for (n = 0; n < 60; n++)
+                processEventsClock(SECONDTICK, 0);
+            tTicks += nowNs() - t0;
+            ticks += 60;
+            errors += compare(t);
+        }
+        printf("%-4s  %7ld  %12ld\n", nameZone((char) z), (long) ((last - first) / 60), errors);
+    }
+
+    t0 = nowNs();
+    for (n = 0; n < 1000000L; n++)
+        setZoneClock((char) (n % NZONES));
+    printf("Second tick: %.1f ns, zone switch: %.1f ns, conversion per display update: none\n",
+           (double) tTicks / ticks, (nowNs() - t0) / 1e6);
+    return 0;
+}
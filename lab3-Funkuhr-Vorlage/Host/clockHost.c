@@ -0,0 +1,178 @@
+/*  Radio signal clock - Host (PC) main program
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: clockHost [minutes] [-v] [-e] [-b ticks]
+                     [-t file [-j ms] [-g glitches/s] [-d dropouts/h]]
+    Runs the radio clock with the simulated DCF77 signal of dcf77Sim.c for the
+    given number of minutes (default 8 hours) as fast as possible and prints
+    the LCD contents. With -v the LCD is printed once every simulated minute.
+    With -e the signal is not polled, but its edges are fed as timestamps
+    like the input capture on the target does. With -b the main loop only
+    runs every n ticks, simulating a main loop blocked by the LCD.
+    With -t the signal is replayed from a trace file (see dcf77Trace.c),
+    which is looped, optionally with edge jitter up to +-ms, glitches of up
+    to 5ms and dropouts of 2 minutes.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "clock.h"
+#include "ticker.h"
+#include "events.h"
+#include "profile.h"
+#include "load.h"
+#include "task.h"
+#include "halHost.h"
+#include "dcf77Trace.h"
+
+#ifdef PROFILING
+// ****************************************************************************
+// Print the run time statistics collected by the profiling probes
+static void printProfiles(void)
+{   static const char *names[NPROFILES] = { "tick10ms", "captureDCF77", "filterDCF77",
+        "tickButtons", "processEventsClock", "processEventsDCF77", "displayTimeClock",
+        "displayDateDcf77" };
+    int n, bin;
+
+    printf("%-20s %8s %6s %6s %8s   log2 histogram (ns)\n", "probe", "count", "min", "max", "mean");
+    for (n = 0; n < NPROFILES; n++)
+    {   if (profiles[n].count == 0)
+            continue;
+        printf("%-20s %8lu %6u %6u %8.1f  ", names[n], profiles[n].count, profiles[n].min,
+               profiles[n].max, (double) profiles[n].sum / profiles[n].count);
+        for (bin = 0; bin < PROFILEBINS; bin++)
+            printf(" %u", profiles[n].histogram[bin]);
+        printf("\n");
+    }
+}
+#endif
+
+// ****************************************************************************
+// Print the statistics of the task scheduler, latencies in simulated time
+static void printTasks(void)
+{   static const char *names[NTASKS] = { "clock", "DCF77", "buttons", "display", "classify" };
+    int n;
+
+    printf("%-8s %8s %8s %8s %11s %7s %9s\n", "task", "runs", "mean ns", "max ns", "max latency", "misses",
+           "overflows");
+    for (n = 0; n < NTASKS; n++)
+        printf("%-8s %8lu %8.0f %8u %9.1fms %7u %9u\n", names[n], taskStats[n].runs,
+               taskStats[n].runs ? (double) taskStats[n].runTime / taskStats[n].runs : 0.0,
+               taskStats[n].maxRunTime, taskStats[n].maxLatency * 1000.0 / TIMERHZ, taskStats[n].misses,
+               taskStats[n].overflows);
+}
+
+// ****************************************************************************
+// Run the clock for a number of 10ms steps of the simulated signal, feeding
+// its edges as timestamps
+static void runEdgesSim(long steps)
+{   static unsigned long signalTime = 0;
+    static char lastSignal = 0;
+    char signal;
+
+    for (; steps > 0; steps--)
+    {   signalTime += TIMER10MS;
+        signal = readPortSim();
+        if (signal != lastSignal)
+        {   edgeHost(signalTime, signal);
+            lastSignal = signal;
+        }
+    }
+    runUntilHost(signalTime);
+}
+
+// ****************************************************************************
+// Run the clock up to a point of time, feeding the edges of the trace file
+// as timestamps
+static void runEdgesTrace(unsigned long until)
+{   static double edgeTime;
+    static char level, pending = 0;
+
+    for (;;)
+    {   if (!pending && !nextEdgeTrace(&edgeTime, &level))
+            break;
+        pending = 1;
+        if (edgeTime * (TIMERHZ / 1000.0) >= until)
+            break;
+        edgeHost((unsigned long) (edgeTime * (TIMERHZ / 1000.0)), level);
+        pending = 0;
+    }
+    runUntilHost(until);
+}
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   long minutes = 8 * 60, m;
+    int verbose = 0, edges = 0, n;
+    const char *trace = NULL;
+    struct timespec t0, t1;
+    double seconds;
+
+    for (n = 1; n < argc; n++)
+    {   if (strcmp(argv[n], "-v") == 0)
+            verbose = 1;
+        else if (strcmp(argv[n], "-e") == 0)
+            edges = 1;
+        else if (strcmp(argv[n], "-b") == 0 && n + 1 < argc)
+            setMainLoopPeriodHost(atoi(argv[++n]));
+        else if (strcmp(argv[n], "-t") == 0 && n + 1 < argc)
+            trace = argv[++n];
+        else if (strcmp(argv[n], "-j") == 0 && n + 1 < argc)
+            setJitterTrace(atof(argv[++n]), 1);
+        else if (strcmp(argv[n], "-g") == 0 && n + 1 < argc)
+            setGlitchesTrace(atof(argv[++n]), 5);
+        else if (strcmp(argv[n], "-d") == 0 && n + 1 < argc)
+            setDropoutsTrace(atof(argv[++n]), 120);
+        else
+            minutes = atol(argv[n]);
+    }
+
+    if (trace != NULL && !openTrace(trace, 1))
+    {   fprintf(stderr, "Cannot read trace file %s\n", trace);
+        return 1;
+    }
+    if (edges)
+        setSignalSourceHost(0);                 // Don't poll, edges are fed by runEdges...()
+    else if (trace != NULL)
+        setSignalSourceHost(readPortTrace);
+    initHost();
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (m = 0; m < minutes; m++)
+    {   if (edges && trace != NULL)
+            runEdgesTrace((unsigned long) (m + 1) * MSEC2TIMER(60000));
+        else if (edges)                         // 6000 steps of 10ms per minute
+            runEdgesSim(60L * 100);
+        else                                    // ... or up to the next minute of real time
+            runUntilHost((unsigned long) (m + 1) * MSEC2TIMER(60000));
+        if (verbose)
+            printf("%6ld  |%s|  |%s|  LEDs %02X  phase %+7.3fms\n", m + 1, lcdHost[0], lcdHost[1],
+                   ledsHost, clockPhase * 1000.0 / TIMERHZ);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    seconds = (double) (t1.tv_sec - t0.tv_sec) + (double) (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    printf("LCD:  |%s|\n      |%s|\n", lcdHost[0], lcdHost[1]);
+    printf("Lost events: %u, LCD bytes: %lu, ticker interrupts: %.1f/s\n", eventOverflows, lcdBytesHost,
+           minutes > 0 ? tickerInterruptsHost / (minutes * 60.0) : 0.0);
+    printf("Simulated %ld min in %.3f s (%.0fx real time)\n",
+           minutes, seconds, seconds > 0 ? (double) minutes * 60.0 / seconds : 0.0);
+    printTasks();
+#ifdef CPULOAD
+    printf("Load of the last second: ISR %u%%, main loop %u%%, clock %u%%, DCF77 %u%%, buttons %u%%, display %u%%\n",
+           loadShares[LOADISR], loadShares[LOADMAIN], loadShares[LOADCLOCK], loadShares[LOADDCF77],
+           loadShares[LOADBUTTONS], loadShares[LOADDISPLAY]);
+#endif
+#ifdef PROFILING
+    printProfiles();
+#endif
+    return 0;
+}
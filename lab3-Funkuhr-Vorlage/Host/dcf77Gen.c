@@ -0,0 +1,359 @@
+/*  Radio signal clock - DCF77 signal generator for the host (PC) build
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Unlike dcf77Sim.c, which repeats 8 fixed frames, the generator encodes
+    the frames of consecutive minutes for any date. Like readPortSim(),
+    readPortGen() must be called once every 10ms (or at the rate selected by
+    setStepGen()) and returns the signal level. Optionally the bits are
+    disturbed: a flipped bit is sent with the pulse length of the other bit
+    value, an erased bit with a 150ms pulse, which the decoder must reject.
+    Glitches invert the signal for a few milliseconds at random times, edge
+    jitter moves both edges of each pulse and fading holds the signal High
+    for some seconds, like a receiver which lost the carrier.
+    Optionally the frames follow the EU DST rule and announce the changeover
+    in bit 16, and a leap second is inserted and announced in bit 19.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "halHost.h"
+#include "dcf77Gen.h"
+
+static GENTIME current;                         // Time of the current minute
+static GENTIME next;                            // Time encoded in the frame being sent
+static char frame[59];
+static int second = 0, ms = 0;                  // Position in the minute
+static int step = 10;                           // Milliseconds per sample
+static int pulse = 0;                           // Length of the current low pulse in ms
+static double flipRate = 0, eraseRate = 0;      // Bit error probabilities
+static double glitchRate = 0;                   // Glitches per sample
+static int glitchMax = 0, glitch = 0;           // Maximum and remaining length in ms
+static int jitterMax = 0;                       // Edge jitter +-ms
+static int fall = 0;                            // Falling edge of the current second in ms
+static double fadeRate = 0;                     // Fades per second
+static int fadeMean = 0, fade = 0;              // Mean and remaining length in seconds
+static unsigned long randomState = 1;
+static char changeover = 0;                     // Follow the EU DST rule
+static GENTIME leap;                            // Leap second at the end of this minute
+static char leapSet = 0;
+static char leapNow = 0;                        // Current minute has 61 seconds
+
+static const int monthDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+// ****************************************************************************
+// Encode the 59 bits of a DCF77 frame
+// Parameter:   frame to fill with 0 and 1, time and date transmitted
+// Returns:     -
+// Note:        Bits 0..16 (weather data, call bit, changeover announcement)
+//              are 0. Bit 17 and 18 tell CEST or CET, bit 20 is always 1.
+void encodeFrameGen(char frame[59], const GENTIME *t)
+{   static const char weights[8] = { 1, 2, 4, 8, 10, 20, 40, 80 };
+    static const struct { char first, bits, parity; } fields[6] =
+    {   { 21, 7, 28 }, { 29, 6, 35 }, { 36, 6, 58 }, { 42, 3, 58 }, { 45, 5, 58 }, { 50, 8, 58 } };
+    int values[6];
+    int i, n, value;
+
+    values[0] = t->minute;
+    values[1] = t->hour;
+    values[2] = t->day;
+    values[3] = t->weekday;
+    values[4] = t->month;
+    values[5] = t->year % 100;
+
+    for (i = 0; i < 59; i++)
+        frame[i] = 0;
+    frame[17] = (char) (t->summer != 0);
+    frame[18] = (char) (t->summer == 0);
+    frame[20] = 1;
+    for (n = 0; n < 6; n++)                     // BCD fields with even parity
+    {   value = values[n] / 10 * 16 + values[n] % 10;
+        for (i = 0; i < fields[n].bits; i++)
+        {   if (value & (weights[i] < 10 ? weights[i] : weights[i] / 10 * 16))
+            {   frame[fields[n].first + i] = 1;
+                frame[(int) fields[n].parity] ^= 1;
+            }
+        }
+    }
+}
+
+// ****************************************************************************
+// Advance a time by one minute, including the date
+// Parameter:   time
+// Returns:     -
+// Note:        The summer time flag is not changed
+void nextMinuteGen(GENTIME *t)
+{   int days;
+
+    if (++t->minute < 60)
+        return;
+    t->minute = 0;
+    if (++t->hour < 24)
+        return;
+    t->hour = 0;
+    t->weekday = t->weekday % 7 + 1;
+    days = monthDays[t->month - 1];
+    if (t->month == 2 && t->year % 4 == 0 && (t->year % 100 != 0 || t->year % 400 == 0))
+        days = 29;
+    if (++t->day <= days)
+        return;
+    t->day = 1;
+    if (++t->month <= 12)
+        return;
+    t->month = 1;
+    t->year++;
+}
+
+// ****************************************************************************
+// Compare the minute of two times, the summer time flag is not compared
+static int sameMinuteGen(const GENTIME *a, const GENTIME *b)
+{   return a->year == b->year && a->month == b->month && a->day == b->day
+        && a->hour == b->hour && a->minute == b->minute;
+}
+
+// ****************************************************************************
+// Advance the time transmitted by one minute, with the DST changeover at
+// 02:00 CET on the last Sunday of March and 03:00 CEST on the last Sunday
+// of October, if enabled
+static void advanceGen(GENTIME *t)
+{   nextMinuteGen(t);
+    if (!changeover || t->minute != 0 || t->weekday != 7 || t->day < 25)
+        return;
+    if (t->month == 3 && !t->summer && t->hour == 2)
+    {   t->hour = 3;
+        t->summer = 1;
+    } else if (t->month == 10 && t->summer && t->hour == 3)
+    {   t->hour = 2;
+        t->summer = 0;
+    }
+}
+
+// ****************************************************************************
+// DST changeover announcement: bit 16 is set from 01:01 CET or 02:01 CEST up
+// to the first minute after the changeover
+static char announceGen(const GENTIME *t)
+{   if (t->weekday != 7 || t->day < 25)
+        return 0;
+    return (char) ((t->month == 3 && ((!t->summer && t->hour == 1 && t->minute > 0)
+                                      || (t->summer && t->hour == 3 && t->minute == 0)))
+                || (t->month == 10 && ((t->summer && t->hour == 2 && t->minute > 0)
+                                       || (!t->summer && t->hour == 2 && t->minute == 0))));
+}
+
+// ****************************************************************************
+// Add one hour to a time, including the date
+static void nextHourGen(GENTIME *t)
+{   int minute = t->minute;
+
+    t->minute = 59;
+    nextMinuteGen(t);
+    t->minute = minute;
+}
+
+// ****************************************************************************
+// Encode the frame transmitted for a minute given in UTC
+// Parameter:   frame to fill with 0 and 1, the time transmitted is returned
+//              in local (CET or CEST), UTC time, its summer flag is ignored
+// Returns:     -
+// Note:        The time follows the EU DST rule, CEST from 01:00 UTC on the
+//              last Sunday of March to 01:00 UTC on the last Sunday of
+//              October. Bit 16 announces the changeover, bit 19 is 0.
+void encodeUTCGen(char frame[59], GENTIME *local, const GENTIME *utc)
+{   int lastSunday = 31 - (utc->weekday + 31 - utc->day) % 7;  // March and October
+
+    *local = *utc;
+    local->summer = (char) ((utc->month > 3 && utc->month < 10)
+        || (utc->month == 3 && (utc->day > lastSunday || (utc->day == lastSunday && utc->hour >= 1)))
+        || (utc->month == 10 && (utc->day < lastSunday || (utc->day == lastSunday && utc->hour < 1))));
+    nextHourGen(local);                         // CET
+    if (local->summer)
+        nextHourGen(local);                     // CEST
+    encodeFrameGen(frame, local);
+    frame[16] = announceGen(local);
+}
+
+// ****************************************************************************
+// Encode the frame of the next minute, with the announcement bits: bit 16
+// before the DST changeover, see announceGen(), bit 19 in the hour up to the
+// minute after the leap second
+static void encodeGen(void)
+{   GENTIME after;
+
+    encodeFrameGen(frame, &next);
+    if (changeover)
+        frame[16] = announceGen(&next);
+    if (leapSet)
+    {   after = leap;
+        nextMinuteGen(&after);
+        frame[19] = (char) (sameMinuteGen(&next, &after) || (next.year == leap.year && next.month == leap.month
+                            && next.day == leap.day && next.hour == leap.hour && next.minute > 0));
+    }
+}
+
+// ****************************************************************************
+// Start the signal
+// Parameter:   time of the current minute, second of this minute to start with
+// Returns:     -
+void startGen(const GENTIME *t, int startSecond)
+{   current = *t;
+    next = *t;
+    leapNow = (char) (leapSet && sameMinuteGen(&current, &leap));
+    advanceGen(&next);
+    encodeGen();
+    second = startSecond;
+    ms = -step;
+}
+
+// ****************************************************************************
+// Follow the EU DST rule, must be called before startGen()
+// Parameter:   1 to switch between CET and CEST, 0 to keep the summer flag
+// Returns:     -
+void setChangeoverGen(char on)
+{   changeover = on;
+}
+
+// ****************************************************************************
+// Insert a leap second, must be called before startGen()
+// Parameter:   minute at the end of which the leap second is inserted, in
+//              the time transmitted, NULL for none
+// Returns:     -
+// Note:        The minute has 61 seconds, second 59 carries a 0 bit.
+void setLeapSecondGen(const GENTIME *t)
+{   leapSet = (char) (t != NULL);
+    if (t)
+        leap = *t;
+}
+
+// ****************************************************************************
+// Select the sample rate of readPortGen(), must be called before startGen()
+// Parameter:   milliseconds per sample, must divide 1000 (default 10)
+// Returns:     -
+void setStepGen(int milliseconds)
+{   step = milliseconds;
+}
+
+// ****************************************************************************
+// Disturb the signal
+// Parameter:   probability of a flipped bit and of an erased bit,
+//              seed of the random numbers
+// Returns:     -
+void setNoiseGen(double flip, double erase, unsigned long seed)
+{   flipRate = flip;
+    eraseRate = erase;
+    randomState = seed ? seed : 1;
+}
+
+// ****************************************************************************
+// Add glitches, i.e. short pulses of the opposite level, at random times
+// Parameter:   mean number of glitches per second, maximum length in ms
+// Returns:     -
+void setGlitchesGen(double perSecond, int maxLength)
+{   glitchRate = perSecond / 1000.0;
+    glitchMax = maxLength;
+    glitch = 0;
+}
+
+// ****************************************************************************
+// Move the edges of the pulses at random
+// Parameter:   maximum offset of each edge in ms, 0 for none
+// Returns:     -
+// Note:        The falling edges are delayed by jitter ms on average, so the
+//              second starts jitter ms late.
+void setJitterGen(int maxOffset)
+{   jitterMax = maxOffset;
+    fall = 0;
+}
+
+// ****************************************************************************
+// Let the signal fade out, i.e. stay High, at random times
+// Parameter:   mean number of fades per hour, mean length in seconds
+// Returns:     -
+void setFadingGen(double perHour, int meanLength)
+{   fadeRate = perHour / 3600.0;
+    fadeMean = meanLength;
+    fade = 0;
+}
+
+// ****************************************************************************
+// Time and date of the current minute, i.e. the time a decoder should show
+// after the last minute marker
+const GENTIME *timeGen(void)
+{   return &current;
+}
+
+// ****************************************************************************
+// Random number in [0, 1), xorshift generator
+static double randomGen(void)
+{   randomState ^= (randomState << 13) & 0xFFFFFFFFUL;
+    randomState ^= randomState >> 17;
+    randomState ^= (randomState << 5) & 0xFFFFFFFFUL;
+    return (double) (randomState & 0xFFFFFFFFUL) / 4294967296.0;
+}
+
+// ****************************************************************************
+// Signal source, must be called once every 10ms (see setStepGen())
+// Parameter:   -
+// Returns:     0 if the signal is Low, 1 if High
+char readPortGen(void)
+{   double r;
+    char signal;
+
+    if ((ms += step) >= 1000)                   // Next second
+    {   ms = 0;
+        if (++second >= 60 + leapNow)           // Next minute
+        {   second = 0;
+            current = next;
+            leapNow = (char) (leapSet && sameMinuteGen(&current, &leap));
+            advanceGen(&next);
+            encodeGen();
+        }
+    }
+    if (ms == 0)                                // Length of the low pulse of this second
+    {   pulse = 0;
+        if (second < 59 + leapNow)
+        {   pulse = second < 59 && frame[second] ? 200 : 100;
+            r = randomGen();
+            if (r < flipRate)
+                pulse = 300 - pulse;
+            else if (r < flipRate + eraseRate)
+                pulse = 150;
+            if (jitterMax > 0)
+            {   fall = (int) (randomGen() * (2 * jitterMax + 1));
+                pulse += (int) (randomGen() * (2 * jitterMax + 1)) - jitterMax;
+            }
+        }
+        if (fade > 0)
+            fade--;
+        else if (fadeRate > 0 && randomGen() < fadeRate)
+            fade = 1 + (int) (randomGen() * (2 * fadeMean - 1));
+    }
+    signal = (char) (fade > 0 || ms < fall || ms >= fall + pulse);
+
+    if (glitch <= 0 && glitchRate > 0 && randomGen() < glitchRate * step)
+        glitch = 1 + (int) (randomGen() * glitchMax);
+    if (glitch > 0)
+    {   glitch -= step;
+        signal ^= 1;
+    }
+    return signal;
+}
+
+// ****************************************************************************
+// Check whether the LCD of the host build shows the time and date of the
+// current minute, the seconds and the time zone are not compared
+// Parameter:   -
+// Returns:     1 if the time and date are shown
+int lcdShowsTimeGen(void)
+{   static const char *weekdays[7] = { "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+    char expected[20];
+
+    sprintf(expected, "%02d:%02d", current.hour, current.minute);
+    if (strncmp(lcdHost[0], expected, 5) != 0)
+        return 0;
+    sprintf(expected, "%s%02d.%02d.%04d", weekdays[current.weekday - 1], current.day, current.month, current.year);
+    return strncmp(lcdHost[1], expected, 13) == 0;
+}
@@ -0,0 +1,30 @@
+/*  Header for the DCF77 signal generator of the host (PC) build
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Data type for the time and date transmitted in one frame
+typedef struct
+{   int year, month, day, weekday;              // weekday 1 = Monday ... 7 = Sunday
+    int hour, minute;
+    char summer;                                // Summer time (CEST) flag
+} GENTIME;
+
+// Public functions, for details see dcf77Gen.c
+void encodeFrameGen(char frame[59], const GENTIME *t);
+void nextMinuteGen(GENTIME *t);
+void encodeUTCGen(char frame[59], GENTIME *local, const GENTIME *utc);
+void startGen(const GENTIME *t, int second);
+void setChangeoverGen(char on);
+void setLeapSecondGen(const GENTIME *t);
+void setStepGen(int milliseconds);
+void setNoiseGen(double flipRate, double eraseRate, unsigned long seed);
+void setGlitchesGen(double perSecond, int maxLength);
+void setJitterGen(int maxOffset);
+void setFadingGen(double perHour, int meanLength);
+const GENTIME *timeGen(void);
+char readPortGen(void);
+int lcdShowsTimeGen(void);
@@ -0,0 +1,324 @@
+/*  Radio signal clock - DCF77 trace file signal source for the host (PC) build
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Replays a recorded DCF77 signal from a text file. The file is streamed,
+    only the next edge is kept in memory, so traces of days can be replayed.
+    Lines starting with '#' are comments, the first other line selects the
+    format:
+        levels <ms>     the signal sampled every <ms> milliseconds, one
+                        character '0' (Low) or '1' (High) per sample,
+                        white space is ignored
+        edges [<ms>]    one edge per line: time in ms since the start of
+                        the trace and the level after the edge, e.g.
+                        "1200.5 1". The optional length of the trace is
+                        used when looping, default: the last edge rounded
+                        up to a full second.
+    build/makeTrace writes such files from the signal of dcf77Gen.c.
+
+    Like readPortGen(), readPortTrace() must be called once every 10ms (or
+    at the rate selected by setStepTrace()) and returns the signal level.
+    nextEdgeTrace() returns the edges with their timestamps instead, e.g.
+    for edgeHost(). Use only one of both for a trace. While replaying, the
+    signal may be disturbed: the edges of the trace are shifted by random
+    jitter, dropouts hold the signal High for some seconds and glitches
+    invert it for a few milliseconds, both at random times.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "dcf77Trace.h"
+
+#define NEVER   1e300                           // Time of an event which does not happen
+
+static FILE *file = NULL;
+static long dataStart;                          // File position of the first sample or edge
+static char edges;                              // Format: 1 = edges, 0 = levels
+static char loop;
+static double period;                           // Levels: ms per sample
+static double length;                           // Edges: ms per pass, 0 = from the last edge
+static double offset;                           // Start of the current pass in ms
+static long samples;                            // Levels: samples read in this pass
+static double lastTime;                         // Edges: last time read in this pass
+static char passData;                           // Data found in this pass
+static char fileLevel;                          // Level of the last sample read
+static char ended;
+
+static char traceLevel;                         // Level of the trace without disturbances
+static double traceEdge;                        // Next edge of the trace, jitter added
+static char traceEdgeLevel;
+static char outputLevel;                        // Level with dropouts and glitches
+static double pendingTime;                      // Next edge of the output, see readPortTrace()
+static char pendingLevel, pendingValid;
+static double sampleTime;                       // Next sample of readPortTrace() in ms
+static char sampleLevel;
+static int step = 10;                           // Milliseconds per sample of readPortTrace()
+
+static double jitter = 0;                       // Maximum edge jitter in ms
+static double dropoutRate = 0, dropoutLength = 0;   // Dropouts per ms, length in ms
+static double glitchRate = 0;                   // Glitches per ms
+static int glitchMax = 0;                       // Maximum length in ms
+static double dropoutStart, dropoutEnd;         // Next dropout, NEVER if none
+static double glitchStart, glitchEnd;
+static unsigned long randomState = 1;
+
+// ****************************************************************************
+// Random number in [0, 1), xorshift generator as in dcf77Gen.c
+static double randomTrace(void)
+{   randomState ^= (randomState << 13) & 0xFFFFFFFFUL;
+    randomState ^= randomState >> 17;
+    randomState ^= (randomState << 5) & 0xFFFFFFFFUL;
+    return (double) (randomState & 0xFFFFFFFFUL) / 4294967296.0;
+}
+
+// Time from now to the next event of a Poisson process
+static double waitTrace(double rate)
+{   return rate > 0 ? -log(1.0 - randomTrace()) / rate : NEVER;
+}
+
+// ****************************************************************************
+// Select the sample rate of readPortTrace(), must be called before openTrace()
+// Parameter:   milliseconds per sample (default 10)
+// Returns:     -
+void setStepTrace(int milliseconds)
+{   step = milliseconds;
+}
+
+// ****************************************************************************
+// Disturb the edges of the trace, must be called before openTrace()
+// Parameter:   maximum jitter in ms, each edge is shifted by a random time
+//              in -jitter ... +jitter; seed of the random numbers
+// Returns:     -
+void setJitterTrace(double milliseconds, unsigned long seed)
+{   jitter = milliseconds;
+    randomState = seed ? seed : 1;
+}
+
+// ****************************************************************************
+// Add dropouts, must be called before openTrace()
+// Parameter:   mean number of dropouts per hour, length in seconds
+// Returns:     -
+void setDropoutsTrace(double perHour, double seconds)
+{   dropoutRate = perHour / 3600000.0;
+    dropoutLength = seconds * 1000.0;
+}
+
+// ****************************************************************************
+// Add glitches, must be called before openTrace()
+// Parameter:   mean number of glitches per second, maximum length in ms
+// Returns:     -
+void setGlitchesTrace(double perSecond, int maxLength)
+{   glitchRate = perSecond / 1000.0;
+    glitchMax = maxLength;
+}
+
+// ****************************************************************************
+// Read the next edge of the trace, loop at its end
+// Parameter:   time in ms and level after the edge
+// Returns:     0 at the end of the trace
+static int readEdgeTrace(double *time, char *level)
+{   char line[80];
+    double t;
+    int c, l;
+
+    for (;;)
+    {   if (edges)
+        {   if (fgets(line, sizeof(line), file) != NULL)
+            {   if (line[0] == '#' || sscanf(line, "%lf %d", &t, &l) != 2)
+                    continue;
+                passData = 1;
+                lastTime = t;
+                *time = offset + t;
+                *level = (char) (l != 0);
+                return 1;
+            }
+        } else
+        {   while ((c = getc(file)) != EOF)
+            {   if (c == '#')                   // Comment up to the end of the line
+                {   while ((c = getc(file)) != EOF && c != '\n')
+                        ;
+                    continue;
+                }
+                if (c != '0' && c != '1')
+                    continue;
+                t = offset + samples++ * period;
+                passData = 1;
+                if ((char) (c == '1') != fileLevel)
+                {   fileLevel = (char) (c == '1');
+                    *time = t;
+                    *level = fileLevel;
+                    return 1;
+                }
+            }
+        }
+        if (!loop || !passData)                 // End of the file
+            return 0;
+        if (edges)
+            offset += length > 0 ? length : ceil(lastTime / 1000.0 + 1e-9) * 1000.0;
+        else
+            offset += samples * period;
+        samples = 0;
+        passData = 0;
+        fseek(file, dataStart, SEEK_SET);
+    }
+}
+
+// ****************************************************************************
+// Read the next edge of the trace and add jitter, edges keep their order
+static void advanceTrace(void)
+{   double previous = traceEdge;
+
+    if (!readEdgeTrace(&traceEdge, &traceEdgeLevel))
+    {   traceEdge = NEVER;
+        return;
+    }
+    if (jitter > 0)
+        traceEdge += jitter * (2.0 * randomTrace() - 1.0);
+    if (traceEdge <= previous)
+        traceEdge = previous + 0.001;
+}
+
+// ****************************************************************************
+// Open a trace file and start replaying it
+// Parameter:   file name, 1 to start again at its end
+// Returns:     1 if the file was opened, 0 on error
+int openTrace(const char *name, char loopTrace)
+{   char line[80];
+
+    closeTrace();
+    if ((file = fopen(name, "r")) == NULL)
+        return 0;
+    do
+    {   if (fgets(line, sizeof(line), file) == NULL)
+        {   closeTrace();
+            return 0;
+        }
+    } while (line[0] == '#' || line[0] == '\n');
+    length = 0;
+    if (sscanf(line, "levels %lf", &period) == 1 && period > 0)
+        edges = 0;
+    else if (strncmp(line, "edges", 5) == 0)
+    {   edges = 1;
+        sscanf(line + 5, "%lf", &length);
+    } else
+    {   closeTrace();
+        return 0;
+    }
+    dataStart = ftell(file);
+
+    loop = loopTrace;
+    offset = 0;
+    samples = 0;
+    lastTime = 0;
+    passData = 0;
+    ended = 0;
+    fileLevel = 1;                              // No signal before the first edge
+    traceLevel = 1;
+    outputLevel = 1;
+    traceEdge = -NEVER;
+    advanceTrace();
+    dropoutStart = waitTrace(dropoutRate);
+    dropoutEnd = NEVER;
+    glitchStart = waitTrace(glitchRate);
+    glitchEnd = NEVER;
+    pendingValid = 0;
+    sampleTime = 0;
+    sampleLevel = 1;
+    return 1;
+}
+
+// ****************************************************************************
+// Close the trace file
+void closeTrace(void)
+{   if (file != NULL)
+        fclose(file);
+    file = NULL;
+}
+
+// ****************************************************************************
+// Next edge of the disturbed signal
+// Parameter:   time of the edge in ms since the start of the trace, level
+//              after the edge
+// Returns:     0 at the end of a trace, which does not loop
+int nextEdgeTrace(double *time, char *level)
+{   double t;
+    char newLevel;
+
+    if (file == NULL)
+        return 0;
+    for (;;)
+    {   t = traceEdge;                          // Next event of the trace, dropouts and glitches
+        if (dropoutStart < t)
+            t = dropoutStart;
+        if (dropoutEnd < t)
+            t = dropoutEnd;
+        if (glitchStart < t)
+            t = glitchStart;
+        if (glitchEnd < t)
+            t = glitchEnd;
+        if (traceEdge >= NEVER)                 // Nothing follows the end of the trace
+        {   ended = 1;
+            return 0;
+        }
+
+        if (t == traceEdge)
+        {   traceLevel = traceEdgeLevel;
+            advanceTrace();
+        } else if (t == dropoutStart)
+        {   dropoutStart = NEVER;
+            dropoutEnd = t + dropoutLength;
+        } else if (t == dropoutEnd)
+        {   dropoutEnd = NEVER;
+            dropoutStart = t + waitTrace(dropoutRate);
+        } else if (t == glitchStart)
+        {   glitchStart = NEVER;
+            glitchEnd = t + 1 + (int) (randomTrace() * glitchMax);
+        } else
+        {   glitchEnd = NEVER;
+            glitchStart = t + waitTrace(glitchRate);
+        }
+
+        newLevel = dropoutEnd < NEVER ? 1 : (char) (traceLevel ^ (glitchEnd < NEVER));
+        if (newLevel != outputLevel)
+        {   outputLevel = newLevel;
+            *time = t;
+            *level = newLevel;
+            return 1;
+        }
+    }
+}
+
+// ****************************************************************************
+// Signal source, must be called once every 10ms (see setStepTrace())
+// Parameter:   -
+// Returns:     0 if the signal is Low, 1 if High
+char readPortTrace(void)
+{   for (;;)
+    {   if (!pendingValid)
+        {   pendingValid = (char) nextEdgeTrace(&pendingTime, &pendingLevel);
+            if (!pendingValid)
+            {   sampleLevel = 1;                // End of the trace: no signal
+                break;
+            }
+        }
+        if (pendingTime > sampleTime)
+            break;
+        sampleLevel = pendingLevel;
+        pendingValid = 0;
+    }
+    sampleTime += step;
+    return sampleLevel;
+}
+
+// ****************************************************************************
+// Check for the end of a trace, which does not loop
+// Returns:     1 if all edges have been replayed
+int endedTrace(void)
+{   return ended;
+}
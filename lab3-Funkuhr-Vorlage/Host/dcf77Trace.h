@@ -0,0 +1,18 @@
+/*  Header for the DCF77 trace file signal source of the host (PC) build
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Public functions, for details see dcf77Trace.c
+void setStepTrace(int milliseconds);
+void setJitterTrace(double milliseconds, unsigned long seed);
+void setDropoutsTrace(double perHour, double seconds);
+void setGlitchesTrace(double perSecond, int maxLength);
+int openTrace(const char *name, char loop);
+void closeTrace(void);
+char readPortTrace(void);
+int nextEdgeTrace(double *time, char *level);
+int endedTrace(void);
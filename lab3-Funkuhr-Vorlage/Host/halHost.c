@@ -0,0 +1,313 @@
+/*  Radio signal clock - Hardware abstraction layer for the host (PC) build
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Replaces hal.c and the assembler drivers led.asm, lcd.asm, ticker.asm,
+    capture.asm and button.asm, so the C modules run unchanged on a PC. There is no
+    timer interrupt: runTicksHost() and runUntilHost() advance the real time
+    and, like output compare channel 4, call tick10ms() at the time it
+    programmed last, followed by one pass of the main loop of main.c, as fast
+    as the PC allows. The signal source is called once per 10ms of real time
+    before the interrupts, even if the PLL of clock.c shifts the ticks, and
+    keeps the ticker at one interrupt per tick. Instead of polling a signal
+    source, edgeHost() accepts timestamped edges like the input capture ISR
+    on the target, then the ticker only interrupts when work is due.
+*/
+
+#include <string.h>
+#include <time.h>
+
+#include "led.h"
+#include "lcd.h"
+#include "clock.h"
+#include "zone.h"
+#include "dcf77.h"
+#include "ticker.h"
+#include "hal.h"
+#include "events.h"
+#include "button.h"
+#include "profile.h"
+#include "load.h"
+#include "task.h"
+#include "halHost.h"
+
+unsigned char ledsHost = 0;
+unsigned char buttonsHost = 0;
+char lcdHost[2][17];
+unsigned long eepromWritesHost = 0;
+unsigned long tickerTime = 0;
+unsigned int  tickerTC = 0;
+int tickerTicks = 1;
+int tickerAdjust = 0;
+unsigned long tickerInterruptsHost = 0;
+
+static SIGNALSOURCE signalSource = readPortSim; // Default: simulated DCF77 signal
+static unsigned long signalTime = 0;            // Time of the next call of the signal source
+static char signalLevel = 0;                    // ... and the level it returned last
+static unsigned long hostTime = 0;              // Real time the clock has been run up to
+static unsigned long compareTime = TIMER10MS;   // Time of the next ticker interrupt, see ticker.asm
+static int mainLoopPeriod = 1;                  // Ticks between two passes of the main loop
+static int mainLoopCount = 0;
+static unsigned char buttonIRQ = 0;             // Enabled key wakeup interrupts
+
+// ****************************************************************************
+// Select the DCF77 signal source, must be called before initHost()
+// Parameter:   function returning the signal level, called once every 10ms
+// Returns:     -
+void setSignalSourceHost(SIGNALSOURCE source)
+{   signalSource = source;
+}
+
+// ****************************************************************************
+// Simulate a busy main loop, e.g. blocked by slow LCD output
+// Parameter:   number of 10ms ticks between two passes of the main loop
+// Returns:     -
+void setMainLoopPeriodHost(int ticks)
+{   mainLoopPeriod = ticks > 0 ? ticks : 1;
+}
+
+// ****************************************************************************
+// Initialize all modules in the same order as main() does
+// Parameter:   -
+// Returns:     -
+void initHost(void)
+{   initEvents();
+#ifdef PROFILING
+    initProfile();
+#endif
+    initLoad();
+    initTasks();
+    initLED();
+    initLCD();
+    initClock();
+    initDCF77();
+    initButtons();
+    initTicker();
+    mainLoopCount = 0;
+}
+
+// ****************************************************************************
+// One pass of the main loop, see main.c
+// The PC cannot sleep in idleLoad(), so the main loop switches to idle
+// itself: the time up to the next tick counts as idle
+static void mainLoopHost(void)
+{   runTasks();
+    switchLoad(LOADIDLE);
+}
+
+// ****************************************************************************
+// Run the clock up to a point in time, i.e. all ticker interrupts up to it
+// Parameter:   time in timer counts (see ticker.h)
+// Returns:     -
+void runUntilHost(unsigned long time)
+{   while ((long) (time - compareTime) >= 0)
+    {   tickerTime = compareTime;               // "Interrupt", see ticker.asm
+        tickerTC = (unsigned int) (tickerTime & 0xFFFF);
+        hostTime = tickerTime;
+        while (signalSource && (long) (tickerTime - signalTime) >= 0)
+        {   signalLevel = signalSource();
+            signalTime += TIMER10MS;
+        }
+        tick10ms();
+        compareTime = tickerTime + (unsigned long) ((long) tickerTicks * TIMER10MS + tickerAdjust);
+        tickerInterruptsHost++;
+        if (++mainLoopCount >= mainLoopPeriod)
+        {   mainLoopCount = 0;
+            mainLoopHost();
+        }
+    }
+    if ((long) (time - hostTime) > 0)
+        hostTime = time;
+}
+
+// ****************************************************************************
+// Run the clock for a number of 10ms ticks of real time
+// Parameter:   number of ticks
+// Returns:     -
+void runTicksHost(long ticks)
+{   for (; ticks > 0; ticks--)
+        runUntilHost(hostTime + TIMER10MS);
+}
+
+// ****************************************************************************
+// Feed a timestamped edge of the DCF77 signal like the input capture ISR,
+// the ticks up to the edge are run first
+// Parameter:   time of the edge in timer counts (see ticker.h), should not
+//              lie before the last tick; signal level after the edge
+// Returns:     -
+void edgeHost(unsigned long edgeTime, char signal)
+{   runUntilHost(edgeTime);
+
+    postEvent(DCF77SOURCE, edgeSignalDCF77(edgeTime, signal), edgeTime);
+    mainLoopHost();
+}
+
+// ****************************************************************************
+// Set the signal level returned by readPort(), for benchmarks which call
+// sampleSignalDCF77() themselves instead of running ticks
+// Parameter:   0 if the signal is Low, 1 if High
+// Returns:     -
+void levelHost(char signal)
+{   signalLevel = signal;
+}
+
+// --- Signal source ----------------------------------------------------------
+void initializePort(void)
+{   if (signalSource == readPortSim)
+        initializePortSim();
+}
+
+char readPort(void)
+{   return signalLevel;                         // 0 if edges are fed via edgeHost()
+}
+
+char pollingPort(void)
+{   return (char) (signalSource != 0);
+}
+
+// --- Free-running counter, see hal.c -----------------------------------------
+// On the PC the counter runs with 1ns resolution
+unsigned int readTimer(void)
+{   struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned int) (((unsigned long long) t.tv_sec * 1000000000ULL + (unsigned long long) t.tv_nsec) & 0xFFFF);
+}
+
+// The simulated time, which does not advance while the main loop runs
+unsigned int nowTimer(void)
+{   return (unsigned int) (hostTime & 0xFFFF);
+}
+
+// --- Interrupt lock and sleep, see hal.c -------------------------------------
+// There are no interrupts on the PC, waitIRQ() returns to runTicksHost()
+void disableIRQ(void)
+{
+}
+
+void enableIRQ(void)
+{
+}
+
+void waitIRQ(void)
+{
+}
+
+// --- EEPROM, see hal.c ------------------------------------------------------
+// Kept in RAM, it survives initHost() like the EEPROM survives a reset
+static unsigned int eepromHost[2] = { 0xFFFF, 0xFFFF };
+
+// Erase the EEPROM like a new board
+void clearEEPROMHost(void)
+{   eepromHost[EEPROMTRIM] = 0xFFFF;
+    eepromHost[EEPROMTRIMCHECK] = 0xFFFF;
+}
+
+unsigned int readEEPROM(unsigned char index)
+{   return eepromHost[index];
+}
+
+void writeEEPROM(unsigned char index, unsigned int value)
+{   if (eepromHost[index] != value)
+        eepromWritesHost++;
+    eepromHost[index] = value;
+}
+
+// --- Buttons, see hal.c and button.asm --------------------------------------
+// Press or release buttons like the user does, raises the key wakeup "interrupt"
+// Parameter:   bit mask of the buttons pressed from now on
+void setButtonsHost(unsigned char pressed)
+{   unsigned char wakeup = (unsigned char) (pressed & ~buttonsHost & buttonIRQ);
+
+    buttonsHost = pressed;
+    if (wakeup)
+    {   buttonIRQ &= (unsigned char) ~wakeup;
+        wakeupButtons(wakeup);
+    }
+}
+
+void initButtonPort(void)
+{   buttonsHost = 0;
+    buttonIRQ = BUTTONMASK;
+}
+
+unsigned char readButtons(void)
+{   return (unsigned char) (buttonsHost & BUTTONMASK);
+}
+
+void enableButtonIRQ(unsigned char mask)
+{   buttonIRQ |= mask;
+}
+
+// --- LED sink, see led.asm --------------------------------------------------
+void initLED(void)
+{   ledsHost = 0;
+}
+
+void toggleLED(unsigned char mask)
+{   ledsHost ^= mask;
+}
+
+void setLED(unsigned char mask)
+{   ledsHost |= mask;
+}
+
+void clrLED(unsigned char mask)
+{   ledsHost &= (unsigned char) ~mask;
+}
+
+// --- LCD sink, see lcd.asm --------------------------------------------------
+// Output is written to lcdHost immediately, there is no queue to overflow
+unsigned int lcdOverflows = 0;
+unsigned int lcdMaxTime = 0;                   // No output ISR on the PC
+unsigned long lcdBytesHost = 0;
+static unsigned char lcdAddress = 0;            // DDRAM address of the cursor
+
+void initLCD(void)
+{   memset(lcdHost, ' ', sizeof(lcdHost));      // Clear display
+    lcdHost[0][16] = 0;
+    lcdHost[1][16] = 0;
+    lcdAddress = LCDLINE0;
+    lcdBytesHost = 0;
+    lcdOverflows++;                             // Contents lost, initHost() may be called again
+}
+
+void putLCD(unsigned char entry)
+{   lcdBytesHost++;
+    if (entry & LCDSETCURSOR)                   // Command: set cursor
+        lcdAddress = (unsigned char) (entry & 0x7F);
+    else                                        // Character at the cursor, which moves on
+    {   if ((lcdAddress & 0x3F) < 16)
+            lcdHost[lcdAddress >= LCDLINE1][lcdAddress & 0x3F] = (char) entry;
+        lcdAddress++;
+    }
+}
+
+void delay_10ms(void)
+{
+}
+
+// --- Time source, see ticker.asm --------------------------------------------
+void initTicker(void)
+{   tickerTime = hostTime;                      // Restart the ticker now
+    tickerTC = (unsigned int) (tickerTime & 0xFFFF);
+    tickerTicks = 1;
+    tickerAdjust = 0;
+    tickerInterruptsHost = 0;
+    compareTime = tickerTime + TIMER10MS;
+    signalTime = compareTime;                   // Called once at the next tick
+    signalLevel = 0;
+}
+
+void wakeTicker(void)
+{   long elapsed = (long) (hostTime - tickerTime) - tickerAdjust;
+    int next = (int) ((elapsed > 0 ? elapsed : 0) / TIMER10MS) + 1;
+
+    if (next < tickerTicks)
+    {   tickerTicks = next;
+        compareTime = tickerTime + (unsigned long) ((long) next * TIMER10MS + tickerAdjust);
+    }
+}
@@ -0,0 +1,30 @@
+/*  Header for the host (PC) side of the hardware abstraction layer
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Data type for a signal source, returns 0 if the DCF77 signal is Low, >0 if High
+// A NULL source means the signal is not polled but fed as edges via edgeHost()
+typedef char (*SIGNALSOURCE)(void);
+
+// State of the simulated hardware
+extern unsigned char ledsHost;                  // LEDs on port B
+extern unsigned char buttonsHost;               // Buttons on port H, 1 = pressed
+extern char lcdHost[2][17];                     // Both lines of the LCD display
+extern unsigned long lcdBytesHost;              // Bytes sent to the LCD
+extern unsigned long eepromWritesHost;          // Words written to the EEPROM
+extern unsigned long tickerInterruptsHost;      // Ticker interrupts, see ticker.asm
+
+// Public functions, for details see halHost.c
+void setSignalSourceHost(SIGNALSOURCE source);
+void setMainLoopPeriodHost(int ticks);
+void initHost(void);
+void runTicksHost(long ticks);
+void runUntilHost(unsigned long time);
+void edgeHost(unsigned long edgeTime, char signal);
+void levelHost(char signal);
+void setButtonsHost(unsigned char pressed);
+void clearEEPROMHost(void);
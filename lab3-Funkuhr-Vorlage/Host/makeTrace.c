@@ -0,0 +1,60 @@
+/*  Radio signal clock - Host (PC) tool writing DCF77 trace files
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Usage: makeTrace levels|edges [minutes] [BER in %] > file
+    Writes the signal of dcf77Gen.c, starting on 25.03.2018 00:00 CET and
+    following the DST rule, in one of the formats of dcf77Trace.c to stdout:
+    levels sampled every 10ms, or edges with a resolution of 1ms. The
+    default is one day. With a bit error rate, half of the bad bits are
+    flipped, half erased.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dcf77Gen.h"
+
+// ****************************************************************************
+int main(int argc, char *argv[])
+{   static const GENTIME start = { 2018, 3, 25, 7, 0, 0, 0 };
+    long minutes = argc > 2 ? atol(argv[2]) : 24 * 60;
+    double ber = argc > 3 ? atof(argv[3]) / 100.0 : 0.0;
+    int edges, step;
+    long n, samples;
+    char signal, last = 1;
+
+    if (argc < 2 || (strcmp(argv[1], "levels") != 0 && strcmp(argv[1], "edges") != 0))
+    {   fprintf(stderr, "Usage: makeTrace levels|edges [minutes] [BER in %%]\n");
+        return 1;
+    }
+    edges = strcmp(argv[1], "edges") == 0;
+    step = edges ? 1 : 10;
+    samples = minutes * 60000L / step;
+
+    setChangeoverGen(1);
+    setStepGen(step);
+    startGen(&start, 0);
+    setNoiseGen(ber / 2, ber / 2, 1);
+
+    printf("# dcf77Gen from 25.03.2018 00:00 CET, %ld minutes, BER %.1f%%\n", minutes, ber * 100);
+    if (edges)
+        printf("edges %ld\n", minutes * 60000L);
+    else
+        printf("levels %d\n", step);
+    for (n = 0; n < samples; n++)
+    {   signal = readPortGen();
+        if (!edges)
+            putchar(signal ? '1' : '0');
+        else if (signal != last)
+            printf("%ld %d\n", n * step, signal);
+        last = signal;
+        if (!edges && n % 100 == 99)            // One second per line
+            putchar('\n');
+    }
+    return 0;
+}
@@ -1,23 +1,28 @@
 ;********************************************************************
 ; Module: button.asm
-; Description: This module handles the button inputs and toggles 
-; the EST variable to switch between Amercian and European time
-; when the third button is pressed.
+; Description: Key wakeup interrupt of the push buttons on port H.
+; The ISR only hands the buttons which caused the interrupt to the
+; debounce state machine in button.c, which runs in the 10ms ticker
+; and posts press, long press, repeat and release events.
 ;********************************************************************
 
 ; Export symbols
-    XDEF checkButtons  
+    XDEF isrPortH
 
 ; Import symbols
-    XREF EST
-    XREF delay_0_5_sec
-    
+    XREF wakeupButtons          ; External function void wakeupButtons(unsigned char mask)
+                                ; called in interrupt context
+
 ; RAM: Variable data section
 .data: SECTION
 
 ; ROM: Constant data
 .const: SECTION
 
+.intVect: SECTION
+    ORG $FFCC
+int25:  DC.W isrPortH
+
 ; ROM: Code section
 .init: SECTION
 
@@ -25,31 +30,23 @@
         INCLUDE 'mc9s12dp256.inc'
 
 ;********************************************************************
-; Public interface function: checkButtons ... Checks the button inputs
-; and toggles the EST variable if the third button is pressed.
-; Parameter: -
-; Return:    -
-; Note:      BRCLR needs to be changed to BRSET if program is used in Simulator
-checkButtons:
-    PSHD
-
-    BRCLR PTH,#$08,changeMode   ; Check button for mode change
-
-    PULD
-    RTS
-;********************************************************************
-; Internal function: changeMode ... Toggles the EST variable
+; Internal function: isrPortH ... Interrupt service routine, called
+; when a button on port H is pressed (or bounces)
 ; Parameter: -
 ; Return:    -
-; Note:      To avoid fast toggling, a delay is added before the
-;            function returns.
-changeMode:
-    LDAB EST
-    EORB #$01
-    STAB EST
-    
-    JSR delay_0_5_sec ; Prevents fast toggling
-
-    PULD
-    RTS
-
+; Note:      The interrupt of the buttons is disabled here and enabled
+;            again by button.c, once the button has been released.
+isrPortH:
+    LDAB PIFH                   ; Buttons with a pending interrupt
+    ANDB PIEH
+    STAB PIFH                   ; Clear the interrupt flags, write 1s
+
+    PSHB
+    COMB                        ; Disable the interrupts of these buttons
+    ANDB PIEH
+    STAB PIEH
+    PULB
+
+    JSR wakeupButtons           ; Start debouncing, parameter in B
+
+    RTI
@@ -0,0 +1,108 @@
+/*  Radio signal clock - Push buttons
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    The buttons are not polled by the main loop. A key wakeup interrupt
+    (button.asm) hands a button to the debounce state machine, which runs
+    in the 10ms ticker only while a button is active, the ticker is woken
+    up for it and then requests each next tick with deadlineTicker().
+    After the button has been released, its interrupt is enabled again.
+    No busy waiting.
+*/
+
+#include "button.h"
+#include "events.h"
+#include "ticker.h"
+#include "hal.h"
+#include "load.h"
+
+// Defines, in 10ms ticks
+#define NBUTTONS        4
+#define DEBOUNCE        3                       // Level must be stable for 30ms
+#define LONGPRESS       100                     // Long press after 1s
+#define REPEAT          20                      // ... then repeat every 200ms
+
+// Modul internal global variables
+static unsigned char activeButtons = 0;         // Buttons handled by the state machine
+static unsigned char stableButtons = 0;         // Debounced state, 1 = pressed
+static unsigned char debounceCount[NBUTTONS];   // Ticks the level differed from stableButtons
+static unsigned char heldTicks[NBUTTONS];       // Ticks since press or last repeat
+
+// ****************************************************************************
+//  Initialize button module
+//  Called once before using the module
+void initButtons(void)
+{   unsigned char n;
+
+    activeButtons = 0;
+    stableButtons = 0;
+    for (n = 0; n < NBUTTONS; n++)
+    {   debounceCount[n] = 0;
+        heldTicks[n] = 0;
+    }
+    initButtonPort();
+}
+
+// ****************************************************************************
+// Callback of the key wakeup ISR, hands buttons to the state machine
+// Parameter:   bit mask of the buttons which caused the interrupt
+// Returns:     -
+void wakeupButtons(unsigned char mask)
+{   enterISRLoad();
+    activeButtons |= mask;
+    wakeTicker();                               // Debounce from the next tick on
+    leaveISRLoad();
+}
+
+// ****************************************************************************
+// Debounce state machine, called by tick10ms()
+// Parameter:   -
+// Returns:     -
+// Note:        Posts BUTTONPRESSED after the button was stable for DEBOUNCE ticks,
+//              BUTTONLONGPRESSED after LONGPRESS ticks, BUTTONREPEATED every
+//              REPEAT ticks thereafter and BUTTONRELEASED. While a button is
+//              active, the next tick is requested with deadlineTicker().
+void tickButtons(void)
+{   unsigned char level, bit, n;
+
+    if (activeButtons == 0)                     // Nothing to do most of the time
+        return;
+
+    level = readButtons();
+    for (n = 0, bit = 0x01; n < NBUTTONS; n++, bit <<= 1)
+    {   if (!(activeButtons & bit))
+            continue;
+
+        if ((level ^ stableButtons) & bit)      // Level changed, wait till it is stable
+        {   if (++debounceCount[n] < DEBOUNCE)
+                continue;
+            debounceCount[n] = 0;
+            stableButtons ^= bit;
+            if (stableButtons & bit)
+            {   heldTicks[n] = 0;
+                postEvent(BUTTONSOURCE, BUTTONEVENTCODE(BUTTONPRESSED, n), tickerTime);
+            } else
+            {   postEvent(BUTTONSOURCE, BUTTONEVENTCODE(BUTTONRELEASED, n), tickerTime);
+                activeButtons &= (unsigned char) ~bit;
+                enableButtonIRQ(bit);
+            }
+        } else if (stableButtons & bit)         // Button is held
+        {   debounceCount[n] = 0;
+            if (++heldTicks[n] == LONGPRESS)
+                postEvent(BUTTONSOURCE, BUTTONEVENTCODE(BUTTONLONGPRESSED, n), tickerTime);
+            else if (heldTicks[n] == LONGPRESS + REPEAT)
+            {   heldTicks[n] = LONGPRESS;
+                postEvent(BUTTONSOURCE, BUTTONEVENTCODE(BUTTONREPEATED, n), tickerTime);
+            }
+        } else                                  // Glitch, button was not pressed
+        {   debounceCount[n] = 0;
+            activeButtons &= (unsigned char) ~bit;
+            enableButtonIRQ(bit);
+        }
+    }
+    if (activeButtons != 0)
+        deadlineTicker(tickerTime + TIMER10MS);
+}
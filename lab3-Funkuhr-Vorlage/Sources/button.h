@@ -0,0 +1,22 @@
+/*  Header for button module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Data type for button events, posted into the event queue together with
+// the button number 0 ... 3 (PH0 ... PH3), see BUTTONEVENTCODE()
+typedef enum { NOBUTTONEVENT, BUTTONPRESSED, BUTTONLONGPRESSED, BUTTONREPEATED, BUTTONRELEASED } BUTTONEVENT;
+
+#define BUTTONEVENTCODE(event, button)  ((unsigned char) (((event) << 4) | (button)))
+#define BUTTONEVENTTYPE(code)           ((BUTTONEVENT) ((code) >> 4))
+#define BUTTONNUMBER(code)              ((code) & 0x0F)
+
+// Public functions, for details see button.c
+void initButtons(void);
+
+// Callback functions called in interrupt context, for details see button.c
+void wakeupButtons(unsigned char mask);
+void tickButtons(void);
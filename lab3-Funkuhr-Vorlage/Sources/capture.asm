@@ -0,0 +1,97 @@
+;
+;   Input capture of the DCF77 signal
+;   Uses Enhanced Capture Timer ECT channel 0 (pin PT0)
+;
+;   Computerarchitektur 3
+;   (C) 2018 J. Friedrich, W. Zimmermann
+;   Hochschule Esslingen
+;
+;   Modified: -
+;
+;   Usage:
+;               JSR initCapture --> Initialize input capture
+;                                 (must be called once, the timer itself is
+;                                  turned on by initTicker)
+;
+;   Description:
+;   Channel 0 captures the edges of the DCF77 receiver output on PT0. Only one
+;   edge is armed at a time, rising while the signal is Low and falling while
+;   it is High, and the ISR isrECT0 arms the opposite one. On every edge it
+;   calls the user-provided callback function
+;                   void captureDCF77(unsigned int captureTime, char level)
+;   with the 16 bit timer value latched by the hardware (5.33us resolution) on
+;   the stack and the level after the edge (0 or 1) in register B. The level
+;   is the one of the armed edge, not of the pin when the ISR runs, so a
+;   glitch shorter than the interrupt latency cannot turn a falling into a
+;   rising edge. The edge back of such a glitch is lost, the decoder sees a
+;   pulse of invalid length instead. The callback runs in interrupt context
+;   and must be short.
+;
+
+; Export symbols
+        XDEF initCapture
+
+; Import symbols
+        XREF captureDCF77       ; External function void captureDCF77(unsigned int, char)
+                                ; called on every edge in interrupt context
+
+; Include derivative specific macros
+        INCLUDE 'mc9s12dp256.inc'
+
+; Defines
+TIMER_CH0   equ $01             ; Bit position for channel 0
+TCTL4_CH0   equ $03             ; Mask corresponds to TCTL4 EDG0B, EDG0A
+EDG0A       equ $01             ; ... capture rising edges
+EDG0B       equ $02             ; ... capture falling edges
+
+; RAM: Variable data section
+.data:  SECTION
+
+; ROM: Constant data
+.const: SECTION
+
+.intVect: SECTION
+        ORG $FFEE
+int8:   DC.W isrECT0
+
+
+; ROM: Code section
+.init:  SECTION
+
+;********************************************************************
+; Public interface function: initCapture ... Initialize input capture (called once)
+; Parameter: -
+; Return:    -
+initCapture:
+        bclr DDRT,#TIMER_CH0    ; PT0 as input
+        bclr TIOS,#TIMER_CH0    ; Set channel 0 in "input capture" mode
+        bclr TCTL4,#TCTL4_CH0
+        brset PTT,#TIMER_CH0,initHigh
+        bset TCTL4,#EDG0A       ; Signal Low: wait for the rising edge
+        bra  initArmed
+initHigh:
+        bset TCTL4,#EDG0B       ; Signal High: wait for the falling edge
+initArmed:
+        movb #TIMER_CH0,TFLG1   ; Discard an old capture
+        bset TIE,#TIMER_CH0     ; Enable channel 0 interrupt
+        rts
+
+;********************************************************************
+; Internal function: isrECT0 ... Interrupt service routine, called on every edge on PT0
+; Parameter: -
+; Return:    -
+isrECT0:
+        ldd  TC0                ; Timestamp of the edge --> 1st parameter on the stack
+        pshd
+        movb #TIMER_CH0,TFLG1   ; Clear the interrupt flag, write a 1 to bit 0
+
+        ldab TCTL4              ; Edge captured: rising, i.e. High after it --> 2nd parameter in B
+        andb #EDG0A
+        ldaa TCTL4              ; Arm the opposite edge
+        eora #TCTL4_CH0
+        staa TCTL4
+
+        jsr  captureDCF77       ; external function called on every edge
+        leas 2,sp               ; Remove the parameter
+
+        rti
@@ -7,82 +7,556 @@
     Modified: -
 */
 
-#include <stdio.h>
-
 #include "clock.h"
 #include "lcd.h"
 #include "led.h"
 #include "dcf77.h"
+#include "ticker.h"
+#include "hal.h"
+#include "events.h"
+#include "button.h"
+#include "format.h"
+#include "zone.h"
+#include "profile.h"
+#include "load.h"
 
 // Defines
 #define ONESEC  (1000/10)                       // 10ms ticks per second
 #define MSEC200 (200/10)
 
-// Global variable holding the last clock event
-CLOCKEVENT clockEvent = NOCLOCKEVENT;
+// Software PLL, see syncClock()
+#define MAXSLEW     19                          // Max. phase correction per tick, 0.1ms in timer counts
+#define PHASEGAIN   4                           // 1/PHASEGAIN of the phase error is corrected per second
+#define LOCKWINDOW  ((long) MSEC2TIMER(20))     // Larger phase errors are outliers ...
+#define MAXOUTLIERS 3                           // ... and step the phase, if they persist
+
+// Crystal trim, see trimClock()
+#define ONEMINUTE       (60 * TIMERHZ)          // Timer counts per minute
+#define TRIMMINUTES     10                      // Min. length of the frequency measurement
+#define SAVEMINUTES     60                      // Measurements saved to the EEPROM
+#define MAXTRIMMINUTES  240                     // Max. length, the 32 bit timer counts wrap after 6.4h
+#define MAXTRIM         32767                   // +-0.5 timer counts per tick, i.e. +-266ppm
+
+// Flag for the software PLL, phase error of the last DCF77 second edge in
+// timer counts and number of seconds the PLL is locked
+char clockPLL = 1;
+long clockPhase = 0;
+unsigned int clockLocked = 0;
+
+// Flag for the automatic crystal trim and trim in 1/65536 timer counts per
+// tick (0.008ppm), added to the ticker period
+char clockAutoTrim = 1;
+int clockTrim = 0;
 
 // Modul internal global variables
 static char hrs = 0, mins = 0, secs = 0;
+
+// Calendar, advanced with the time, see nextDayClock()
+static CLOCKDATE date = { 2017, 1, 1, 7, 1, 0 };
+static const char monthLength[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+static const int monthStart[13] = { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+// Time zone of the time and date counted, and its current offset to UTC in
+// minutes, see updateZoneClock()
+static char zone = ZONEDCF77;
+static int offset = 60;
+
 static int uptime = 0;
 static int ticks = 0;
+static int plannedTicks = 1;                    // Ticks of the period programmed last
+static char ledOn = 0;                          // LED B.0 is on, see tick10ms()
+static unsigned long deadline = 0;              // Earliest deadline of the other modules ...
+static char deadlineSet = 0;                    // ... see deadlineTicker()
+
+static unsigned long secondTime = 0;            // Time of the last second tick processed
+static unsigned long secondCount = 0;           // Second ticks processed, see secondsClock()
+static unsigned long edgeTime = 0;              // Time of the last DCF77 second edge
+static char synced = 0;                         // edgeTime is valid
+static char holdSecond = 0;                     // Don't count the next second tick
+static char leapSecond = 0;                     // Current minute has 61 seconds
+static char outliers = 0;                       // Consecutive phase errors outside LOCKWINDOW
+static long lastOutlier = 0;
+static int slew = 0;                            // Phase correction left, interrupt context only
+
+static volatile long phaseError = 0;            // Phase error passed from syncClock() ...
+static volatile char phaseNew = 0;              // ... to tick10ms(), set by main loop, cleared by ISR
+static volatile char restartNew = 0;            // Restart the second on the next tick, dito
+
+static long trimPhase = 0;                      // Fraction of a timer count, interrupt context only
+static unsigned long trimStart = 0;             // First minute marker of the frequency measurement
+static int trimStartMinute = 0;                 // ... and its minute of the day
+static char trimRunning = 0;
+static char trimSaved = 0;                      // Measurement has been saved to the EEPROM
+static unsigned int trimBasis = 0;              // Length of the measurement behind clockTrim in minutes
 
 // ****************************************************************************
 //  Initialize clock module
-//  Called once before using the module
+//  Called once before using the module, resets all state of the clock except
+//  the flags of the PLL and the crystal trim. Time and date are set by
+//  initDCF77() afterwards.
 void initClock(void)
-{   displayTimeClock();
+{   hrs = mins = secs = 0;
+    zone = ZONEDCF77;
+    offset = 60;
+    uptime = 0;
+    ticks = 0;
+    plannedTicks = 1;
+    ledOn = 0;
+    deadlineSet = 0;
+    secondTime = 0;
+    secondCount = 0;
+    edgeTime = 0;
+    synced = 0;
+    holdSecond = 0;
+    leapSecond = 0;
+    outliers = 0;
+    lastOutlier = 0;
+    slew = 0;
+    phaseError = 0;
+    phaseNew = 0;
+    restartNew = 0;
+    clockPhase = 0;
+    clockLocked = 0;
+
+    trimPhase = 0;
+    trimStart = 0;
+    trimStartMinute = 0;
+    trimRunning = 0;
+    trimSaved = 0;
+    clockTrim = 0;
+    trimBasis = 0;
+    if (readEEPROM(EEPROMTRIMCHECK) == (unsigned int) ~readEEPROM(EEPROMTRIM))
+    {   clockTrim = (int) readEEPROM(EEPROMTRIM);   // Trim learned before the reset, a new
+        trimBasis = SAVEMINUTES;                // ... measurement must be as long to replace it
+    }
+    displayTimeClock();
 }
 
 // ****************************************************************************
-// This function is called periodically every 10ms by the ticker interrupt.
+// This function is called by the ticker interrupt on the 10ms ticks with work
+// to do, it handles all ticks since the last call and programs the next call:
+// the second tick, LED off 200ms later and the earliest deadline requested by
+// the other modules with deadlineTicker(), e.g. the buttons while one is
+// active, the DCF77 signal if it is polled and its timeout. Otherwise the
+// ticker sleeps for up to MAXTICKERTICKS ticks, so it interrupts about 7
+// times per second.
 // Keep processing short in this function, run time must not exceed 10ms!
 // Callback function, never called by user directly.
 void tick10ms(void)
-{   if (++ticks >= ONESEC)                      // Check if one second has elapsed
-    {   clockEvent = SECONDTICK;                // ... if yes, set clock event
-        ticks=0;
+{   int elapsed = tickerTicks, next = MAXTICKERTICKS, step, adjust = 0;
+    long wait;
+
+    enterISRLoad();
+    PROFILE_BEGIN(PROFILETICK);
+
+    if (phaseNew)                               // New phase error from syncClock()
+    {   if (phaseError > LOCKWINDOW || phaseError < -LOCKWINDOW)
+        {   step = (int) ((phaseError + (phaseError > 0 ? TIMER10MS / 2 : -TIMER10MS / 2)) / TIMER10MS);
+            ticks -= step;                      // Step by whole ticks ...
+            slew = (int) (phaseError - (long) step * TIMER10MS);    // ... and slew the rest
+        } else
+        {   slew = (int) (phaseError / PHASEGAIN);
+        }
+        phaseNew = 0;
+    }
+    if (restartNew)                             // setClock() without PLL: this is tick 1
+    {   ticks = 1 - elapsed;
+        restartNew = 0;
+    }
+    trimPhase -= (long) clockTrim * (plannedTicks - elapsed);   // Period cut short by wakeTicker()
+
+    ticks += elapsed;
+    if (ticks >= ONESEC)                        // Check if one second has elapsed
+    {   postEvent(CLOCKSOURCE, SECONDTICK, tickerTime); // ... if yes, post clock event
+        ticks -= ONESEC;                        // Keep a phase step of the PLL
         setLED(0x01);                           // ... and turn on LED on port B.0 for 200msec
-    } else if (ticks == MSEC200)
+        ledOn = 1;
+    } else if (ledOn && ticks >= MSEC200)
     {   clrLED(0x01);
+        ledOn = 0;
     }
-    uptime = uptime + 10;                       // Update CPU time base
+    uptime = uptime + 10 * elapsed;             // Update CPU time base
+    deadlineSet = 0;                            // Renewed by the modules below
 
-    dcf77Event = sampleSignalDCF77(uptime);     // Sample the DCF77 signal
+    PROFILE_BEGIN(PROFILEBUTTONS);
+    tickButtons();                              // Debounce the buttons
+    PROFILE_END(PROFILEBUTTONS);
 
-    //--- Add code here, which shall be executed every 10ms -------------------
+#if !defined(DCF77CAPTURE) && !defined(DCF77FILTER)
+    if (pollingPort())
+    {   DCF77EVENT event = sampleSignalDCF77(uptime);   // Sample the DCF77 signal
+        if (event != NODCF77EVENT)
+            postEvent(DCF77SOURCE, event, tickerTime);
+        deadlineTicker(tickerTime + TIMER10MS); // ... again on the next tick
+    }
+#endif
+    if (timeoutDCF77(tickerTime))               // No edge for too long, the signal is lost
+        postEvent(DCF77SOURCE, INVALID, tickerTime);
+
+    //--- Add code here, which shall be executed on the ticks ----------------
     // ???
     //--- End of user code
+
+    if (next > ONESEC - ticks)                  // Next deadline
+        next = ONESEC - ticks;
+    if (ledOn && next > MSEC200 - ticks)
+        next = MSEC200 - ticks;
+    if (deadlineSet)
+    {   wait = (long) (deadline - tickerTime);
+        if (wait < (long) next * TIMER10MS)
+            next = (int) ((wait + TIMER10MS - 1) / TIMER10MS);
+    }
+    if (next < 1)
+        next = 1;
+
+    if (slew != 0)                              // Lengthen or shorten the next period
+    {   step = MAXSLEW * next;
+        adjust = slew > step ? step : (slew < -step ? -step : slew);
+        slew -= adjust;
+    }
+    trimPhase += (long) clockTrim * next;       // Dither the period, e.g. 1875 or 1876 counts per tick
+    while (trimPhase >= 0x8000L)
+    {   adjust++;
+        trimPhase -= 0x10000L;
+    }
+    while (trimPhase < -0x8000L)
+    {   adjust--;
+        trimPhase += 0x10000L;
+    }
+    tickerTicks = next;
+    tickerAdjust = adjust;
+    plannedTicks = next;
+
+    tickLoad(elapsed);                          // Publish the CPU load every second
+    PROFILE_END(PROFILETICK);
+    leaveISRLoad();
+}
+
+// ****************************************************************************
+// Request a ticker interrupt, e.g. for work of another module in tick10ms()
+// Parameter:   time in timer counts, at which tick10ms() must run at the latest
+// Returns:     -
+// Note:        Called in interrupt context, i.e. by tick10ms() itself or an
+//              ISR, which do not interrupt each other. The earliest deadline
+//              requested holds up to the next ticker interrupt, the modules
+//              called by tick10ms() check their work there and request
+//              again. A deadline before the interrupt already programmed
+//              needs wakeTicker() as well.
+void deadlineTicker(unsigned long time)
+{   if (!deadlineSet || (long) (time - deadline) < 0)
+    {   deadline = time;
+        deadlineSet = 1;
+    }
+}
+
+// ****************************************************************************
+// internal function: leapYearClock ... Gregorian leap year rule
+// Parameter:   year
+// Returns:     1 for a leap year, else 0
+static char leapYearClock(int year)
+{   return (char) (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
+}
+
+// ****************************************************************************
+// internal function: daysClock ... Length of a month of the current year
+// Parameter:   month 1 ... 12
+// Returns:     number of days
+static char daysClock(char month)
+{   return (char) (monthLength[(int) month] + (month == 2 && date.leapYear));
+}
+
+// ****************************************************************************
+// internal function: nextDayClock ... Advance the calendar by one day
+// Parameter:   -
+// Returns:     -
+// Note:        Constant time, the leap year rule is only evaluated on
+//              New Year.
+static void nextDayClock(void)
+{   if (++date.weekday > 7)
+        date.weekday = 1;
+    date.yearDay++;
+    if (++date.day > daysClock(date.month))
+    {   date.day = 1;
+        if (++date.month > 12)
+        {   date.month = 1;
+            date.year++;
+            date.yearDay = 1;
+            date.leapYear = leapYearClock(date.year);
+        }
+    }
+}
+
+// ****************************************************************************
+// internal function: previousDayClock ... Move the calendar back by one day
+// Parameter:   -
+// Returns:     -
+static void previousDayClock(void)
+{   if (--date.weekday < 1)
+        date.weekday = 7;
+    date.yearDay--;
+    if (--date.day < 1)
+    {   if (--date.month < 1)
+        {   date.month = 12;
+            date.year--;
+            date.leapYear = leapYearClock(date.year);
+            date.yearDay = 365 + date.leapYear;
+        }
+        date.day = daysClock(date.month);
+    }
+}
+
+// ****************************************************************************
+// internal function: updateZoneClock ... Apply the offset of the zone
+// Parameter:   -
+// Returns:     -
+// Note:        Evaluates the DST rule of the zone for the current UTC hour
+//              and shifts the clock, if the offset changed. Only called on
+//              full UTC hours and when the zone or the time is set, so the
+//              local time is always ready for the display.
+static void updateZoneClock(void)
+{   int newOffset;
+
+    shiftClock(-offset);                        // UTC
+    newOffset = offsetZone(zone, &date, hrs);
+    shiftClock(newOffset);
+    offset = newOffset;
 }
 
 // ****************************************************************************
 // Process the clock events
 // This function is called every second and will update the internal time values.
-// Parameter:   clock event, normally SECONDTICK
+// Parameter:   clock event, normally SECONDTICK, time of the event in timer counts
 // Returns:     -
-void processEventsClock(CLOCKEVENT event)
+void processEventsClock(CLOCKEVENT event, unsigned long eventTime)
 {   if (event==NOCLOCKEVENT)
         return;
 
-    if (++secs >= 60)
+    PROFILE_BEGIN(PROFILECLOCK);
+    secondTime = eventTime;
+    secondCount++;
+    if (holdSecond)                             // setClock() has already counted this second
+    {   holdSecond = 0;
+    } else if (++secs >= 60 + leapSecond)       // 23:59:60 is shown
     {   secs = 0;
+        leapSecond = 0;
         if (++mins >= 60)
         {   mins = 0;
             if (++hrs >= 24)
             {   hrs = 0;
+                nextDayClock();
             }
         }
+        if ((mins - offset % 60) % 60 == 0)     // Full UTC hour, check for DST
+            updateZoneClock();
      }
+    PROFILE_END(PROFILECLOCK);
 }
 
 // ****************************************************************************
 // Allow other modules, e.g. DCF77, so set the time
-// Parameters:  hours, minutes, seconds as integers
+// Parameters:  hours, minutes, seconds as integers, offset of this time to
+//              UTC in minutes, e.g. 60 for CET
 // Returns:     -
-void setClock(char hours, char minutes, char seconds)
+// Note:        Call setDateClock() first, time and date are converted to
+//              the selected zone together. With the PLL, the seconds belong
+//              to the second started by the last edge passed to syncClock(),
+//              and the phase is not touched. If the second tick of this edge
+//              is still to come, it is not counted again.
+void setClock(char hours, char minutes, char seconds, int utcOffset)
 {   hrs  = hours;
     mins = minutes;
     secs = seconds;
-    ticks = 0;
+    leapSecond = 0;
+    offset = utcOffset;
+    updateZoneClock();
+    if (!clockPLL)                              // Count the second from the next tick on
+    {   disableIRQ();
+        restartNew = 1;
+        wakeTicker();
+        enableIRQ();
+        return;
+    }
+    holdSecond = (char) (synced && (long) (edgeTime - secondTime) > TIMERHZ / 2);
+}
+
+// ****************************************************************************
+// Allow other modules, e.g. DCF77, to set the date
+// Parameters:  year, month 1 ... 12, day 1 ... 31, weekday 1 = Monday ... 7
+// Returns:     -
+// Note:        Must be called before setClock(), from then on the date is
+//              advanced at midnight.
+void setDateClock(int year, char month, char day, char weekday)
+{   date.year = year;
+    date.month = month;
+    date.day = day;
+    date.weekday = weekday;
+    date.leapYear = leapYearClock(year);
+    date.yearDay = monthStart[(int) month] + day + (month > 2 && date.leapYear);
+}
+
+// ****************************************************************************
+// Shift the time and date, e.g. into another time zone
+// Parameters:  minutes -1439 ... 1439
+// Returns:     -
+void shiftClock(int minutes)
+{   int m = hrs * 60 + mins + minutes;
+
+    if (m >= 1440)
+    {   m -= 1440;
+        nextDayClock();
+    } else if (m < 0)
+    {   m += 1440;
+        previousDayClock();
+    }
+    hrs = (char) (m / 60);
+    mins = (char) (m % 60);
+}
+
+// ****************************************************************************
+// Select the time zone shown, e.g. when the user presses the button
+// Parameters:  zone 0 ... NZONES-1, see zone.h
+// Returns:     -
+// Note:        The clock is shifted right away, the date rolls over with it.
+void setZoneClock(char newZone)
+{   zone = newZone;
+    updateZoneClock();
+}
+
+// ****************************************************************************
+// Get the time zone shown
+// Parameters:  -
+// Returns:     zone 0 ... NZONES-1, see zone.h
+char zoneClock(void)
+{   return zone;
+}
+
+// ****************************************************************************
+// Get the current date of the clock
+// Parameters:  -
+// Returns:     pointer to the calendar, valid until the next clock event
+const CLOCKDATE *dateClock(void)
+{   return &date;
+}
+
+// ****************************************************************************
+// Software PLL: align the local second to the DCF77 second edges
+// Parameters:  time of a DCF77 second edge in timer counts (see ticker.h)
+// Returns:     -
+// Note:        Called by the DCF77 module in the main loop. The phase error
+//              to the nearest local second tick is handed to tick10ms(),
+//              which slews 1/PHASEGAIN of it by lengthening or shortening
+//              the next ticks by up to MAXSLEW timer counts each, so the seconds
+//              never jump. Only if MAXOUTLIERS consistent errors lie
+//              outside LOCKWINDOW, e.g. before the first lock, the phase
+//              is stepped.
+void syncClock(unsigned long time)
+{   long error;
+
+    if (!clockPLL || phaseNew)
+        return;
+
+    error = (long) (time - secondTime);
+    while (error > TIMERHZ / 2)
+        error -= TIMERHZ;
+    while (error < -TIMERHZ / 2)
+        error += TIMERHZ;
+    edgeTime = time;
+    synced = 1;
+    clockPhase = error;
+
+    if (error <= LOCKWINDOW && error >= -LOCKWINDOW)
+    {   outliers = 0;
+        if (clockLocked < 0xFFFF)
+            clockLocked++;
+    } else
+    {   clockLocked = 0;
+        if (outliers > 0 && error - lastOutlier <= LOCKWINDOW && lastOutlier - error <= LOCKWINDOW)
+            outliers++;
+        else
+            outliers = 1;
+        lastOutlier = error;
+        if (outliers < MAXOUTLIERS)
+            return;
+        outliers = 0;
+    }
+    phaseError = error;
+    phaseNew = 1;                               // Publish the error after it is complete
+}
+
+// ****************************************************************************
+// Number of second ticks processed since the start
+// Parameters:  -
+// Returns:     second ticks, including those not counted by the time
+// Note:        Never set or stepped, so the difference of two readings
+//              measures intervals longer than the 32 bit timer counts,
+//              which wrap after 6.4h, e.g. the gaps of the DCF77 signal.
+unsigned long secondsClock(void)
+{   return secondCount;
+}
+
+// ****************************************************************************
+// Insert a leap second at the end of the current minute
+// Parameters:  -
+// Returns:     -
+// Note:        Called by the DCF77 module at the start of the leap second,
+//              i.e. before its second tick. The frequency measurement of
+//              trimClock() moves its start by one second, so the extra
+//              second is not taken as a frequency error.
+void leapSecondClock(void)
+{   leapSecond = 1;
+    trimStart += TIMERHZ;
+}
+
+// ****************************************************************************
+// Crystal trim: measure the frequency error of the timer against the DCF77
+// minute markers
+// Parameters:  time of a minute marker with a valid frame in timer counts,
+//              minute of the day transmitted in this frame
+// Returns:     -
+// Note:        Called by the DCF77 module in the main loop. The timer counts
+//              between the first marker of a measurement and the following
+//              ones give the frequency error, which clockTrim compensates.
+//              The longer the measurement, the more precise; a shorter one
+//              never replaces a longer one, except when it is restarted
+//              every MAXTRIMMINUTES to follow temperature and aging. The
+//              trim is saved to the EEPROM (see hal.h) at most twice per
+//              measurement, so it survives resets and is used in holdover.
+//              A gap or a frame not matching the elapsed minutes restarts
+//              the measurement.
+void trimClock(unsigned long time, int minuteOfDay)
+{   unsigned long elapsed = time - trimStart;
+    unsigned long minutes = (elapsed + ONEMINUTE / 2) / ONEMINUTE;
+    long trim;
+
+    if (!clockAutoTrim)
+        return;
+
+    if (!trimRunning || minutes > MAXTRIMMINUTES
+        || (int) (minutes % 1440) != (minuteOfDay - trimStartMinute + 1440) % 1440)
+    {   trimStart = time;                       // Start a new measurement
+        trimStartMinute = minuteOfDay;
+        trimRunning = 1;
+        trimSaved = 0;
+        return;
+    }
+    if (minutes < TRIMMINUTES || minutes < trimBasis)
+        return;
+
+    // Error in timer counts, scaled to 1/65536 counts per tick of 6000 per minute
+    trim = (long) (elapsed - minutes * ONEMINUTE) * 64 / (long) minutes * 1024 / 6000;
+    clockTrim = (int) (trim > MAXTRIM ? MAXTRIM : (trim < -MAXTRIM ? -MAXTRIM : trim));
+    trimBasis = (unsigned int) minutes;
+
+    if ((minutes >= SAVEMINUTES && !trimSaved) || minutes >= MAXTRIMMINUTES)
+    {   writeEEPROM(EEPROMTRIM, (unsigned int) clockTrim);
+        writeEEPROM(EEPROMTRIMCHECK, (unsigned int) ~clockTrim);
+        trimSaved = 1;
+    }
+    if (minutes >= MAXTRIMMINUTES)              // Start again, the next measurement
+    {   trimStart = time;                       // ... replaces this one after SAVEMINUTES
+        trimStartMinute = minuteOfDay;
+        trimSaved = 0;
+        trimBasis = SAVEMINUTES;
+    }
 }
 
 // ****************************************************************************
@@ -90,9 +564,12 @@ void setClock(char hours, char minutes, char seconds)
 // Parameter:   -
 // Returns:     -
 void displayTimeClock(void)
-{   char uhrzeit[32] = "00:00:00";
-    (void) sprintf(uhrzeit, "%02d:%02d:%02d", hrs, mins, secs );
+{   char uhrzeit[9];
+
+    PROFILE_BEGIN(PROFILEDISPLAYTIME);
+    formatTime(uhrzeit, hrs, mins, secs);
     writeLine(uhrzeit, 0);
+    PROFILE_END(PROFILEDISPLAYTIME);
 }
 
 // ***************************************************************************
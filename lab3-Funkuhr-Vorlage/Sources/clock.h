@@ -10,11 +10,37 @@
 // Data type for clock events
 typedef enum { NOCLOCKEVENT, SECONDTICK } CLOCKEVENT;
 
-// Global variable holding the last clock event
-extern CLOCKEVENT clockEvent;
+// Data type for the calendar of the clock
+typedef struct
+{   int year;
+    char month, day;                            // 1 ... 12, 1 ... 31
+    char weekday;                               // 1 = Monday ... 7 = Sunday
+    int yearDay;                                // 1 ... 366
+    char leapYear;
+} CLOCKDATE;
+
+// Flag for the software PLL, phase error of the last DCF77 second edge in timer
+// counts (see ticker.h) and seconds since the PLL is locked, for details see clock.c
+extern char clockPLL;
+extern long clockPhase;
+extern unsigned int clockLocked;
+
+// Flag for the automatic crystal trim and trim of the ticker period in 1/65536
+// timer counts per tick, for details see clock.c
+extern char clockAutoTrim;
+extern int clockTrim;
 
 // Public functions, for details see clock.c
 void initClock(void);
-void processEventsClock(CLOCKEVENT event);
-void setClock(char hours, char minutes, char seconds);
+void processEventsClock(CLOCKEVENT event, unsigned long eventTime);
+void setClock(char hours, char minutes, char seconds, int utcOffset);
+void setDateClock(int year, char month, char day, char weekday);
+void shiftClock(int minutes);
+void setZoneClock(char newZone);
+char zoneClock(void);
+const CLOCKDATE *dateClock(void);
+void syncClock(unsigned long time);
+unsigned long secondsClock(void);
+void leapSecondClock(void);
+void trimClock(unsigned long time, int minuteOfDay);
 void displayTimeClock(void);
@@ -7,138 +7,229 @@
     Modified: -
 */
 
-#include <hidef.h>                                      // Common defines
-#include <mc9s12dp256.h>                                // CPU specific defines
-#include <stdio.h>
-
 #include "dcf77.h"
 #include "led.h"
 #include "clock.h"
+#include "zone.h"
 #include "lcd.h"
+#include "hal.h"
+#include "ticker.h"
+#include "events.h"
+#include "format.h"
+#include "profile.h"
+#include "load.h"
 
-// Global variable holding the last DCF77 event
-// possible states:
-//   NODCF77EVENT    - no event
+// DCF77 events posted into the event queue (see events.c)
+// possible events:
 //   VALIDSECOND     - second pulse detected
 //   VALIDZERO       - valid zero bit detected
 //   VALIDONE        - valid one bit detected
 //   VALIDMINUTE     - minute marker detected
 //   INVALID         - invalid signal detected
-DCF77EVENT dcf77Event = NODCF77EVENT;
 
 // Modul internal global variables for the received dcf77 signal
 static int  dcf77Year=2017, dcf77Month=1, dcf77Day=1, dcf77Hour=0, dcf77Minute=0, dcf77Weekday=1;
-// Weekday names will use the dcf77Weekday variable as index (1=Monday, 7=Sunday)
+// Weekday names will use the weekday of the clock as index (1=Monday, 7=Sunday)
 static char dcf77WeekdayNames[7][4] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
 
-// calculated EST time
-// Modul internal global variables for EST time
-static int estYear=2017, estMonth=1, estDay=1, estHour=0, estWeekday=1;
-static int monthDays[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
-
-// *******************************************************************
-// internal function: setESTWithDCF77 ... This function sets the estyear, 
-// estmonth, estday, estweekday and esthour as well as esthour
-// Parameter:   -
-// Returns:     -
-// Note:        It uses the dcf77 values for calculation. 
-//              Thus they must be set correctly.
-void setESTWithDCF77(void) {
-    estYear = dcf77Year;
-    estMonth = dcf77Month;
-    estDay = dcf77Day;
-    estWeekday = dcf77Weekday;
-    // calculate EST time
-    estHour = dcf77Hour - 6;
-    // if the hour is negative, subtract 1 from the day and set the hour to 24 - hour
-    if (estHour < 0) {
-        estHour += 24;
-        estDay = dcf77Day - 1;
-        // set the weekday
-        estWeekday = dcf77Weekday - 1;
-        if (estWeekday == 0) {
-            estWeekday = 7;
-        }
-        // if the day goes below 1, set it to the last day of the previous month
-        if (estDay == 0) {
-            estMonth = dcf77Month - 1;
-            // if the month goes below 1, go to the last month of the previous year
-            if (estMonth == 0) {
-                estMonth = 12;
-                estYear = dcf77Year - 1;
-                estDay = monthDays[11];
-            // if the month is February, set the day to 28 and check for leap year
-            } else if (estMonth == 2) {
-                estDay = 28;
-                if (estYear % 4 == 0) {
-                    if (estYear % 100 != 0 || estYear % 400 == 0) {
-                        estDay = 29;
-                    }
-                }
-            // if the month is not February, set the day to the last day of the previous month
-            } else {
-                estDay = monthDays[estMonth - 1];
-            }
-        }
-    }
-}
+static const char monthDays[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
 
 // Variables for the DCF77 state machine
-static int currentBit = 0;  // Current bit position in the DCF77Buffer
-static char dcf77Buffer[59];  // Buffer for the DCF77 signal bits
+static int currentBit = 0;  // Current bit position in the DCF77 frame
 static char ERROR = 1;  // Error flag
-static char paritySum = 0;  // Parity sum (will be used for parity check)
 
-char EST = 0;  // Flag for EST time
+static char frameError = 0;  // Field range error in the current frame
 
-// Counter for for-loops because they cannot be declared
-// inside the for-loop in this version of C
-int i = 0;
+// Streaming decoder: every data bit is accounted for as soon as it arrives.
+// Each bit belongs to a field and has a BCD weight, the parity groups are
+// tracked as one bit each in parityFlags (minute/P1, hour/P2, date/P3).
+typedef enum { NOFIELD, MINUTE, HOUR, DAY, WEEKDAY, MONTH, YEAR, PARITY1, PARITY2, PARITY3 } DCF77FIELD;
 
-// Prototypes of functions simulation DCF77 signals, when testing without
-// a DCF77 radio signal receiver
-void initializePortSim(void);                   // Use instead of initializePort() for testing
-char readPortSim(void);                         // Use instead of readPort() for testing
+static const unsigned char bitField[59] = {
+    NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD,   //  0 -  9
+    NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD, NOFIELD,   // 10 - 19
+    NOFIELD, MINUTE,  MINUTE,  MINUTE,  MINUTE,  MINUTE,  MINUTE,  MINUTE,  PARITY1,            // 20 - 28
+    HOUR,    HOUR,    HOUR,    HOUR,    HOUR,    HOUR,    PARITY2,                              // 29 - 35
+    DAY,     DAY,     DAY,     DAY,     DAY,     DAY,                                           // 36 - 41
+    WEEKDAY, WEEKDAY, WEEKDAY,                                                                  // 42 - 44
+    MONTH,   MONTH,   MONTH,   MONTH,   MONTH,                                                  // 45 - 49
+    YEAR,    YEAR,    YEAR,    YEAR,    YEAR,    YEAR,    YEAR,    YEAR,    PARITY3             // 50 - 58
+};
+static const unsigned char bitWeight[59] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 2, 4, 8, 10, 20, 40, 0,               // minute, P1
+    1, 2, 4, 8, 10, 20, 0,                      // hour, P2
+    1, 2, 4, 8, 10, 20,                         // day
+    1, 2, 4,                                    // weekday
+    1, 2, 4, 8, 10,                             // month
+    1, 2, 4, 8, 10, 20, 40, 80, 0               // year, P3
+};
+// Per field: parity group, last bit and valid range
+static const unsigned char fieldParity[10]  = { 0, 0x01, 0x02, 0x04, 0x04, 0x04, 0x04, 0x01, 0x02, 0x04 };
+static const unsigned char fieldLastBit[10] = { 0, 27, 34, 41, 44, 49, 57, 0, 0, 0 };
+static const unsigned char fieldMin[10]     = { 0,  0,  0,  1,  1,  1,  0, 0, 0, 0 };
+static const unsigned char fieldMax[10]     = { 0, 59, 23, 31,  7, 12, 99, 0, 0, 0 };
 
-// ****************************************************************************
-// Initalize the hardware port on which the DCF77 signal is connected as input
-// Parameter:   -
-// Returns:     -
-void initializePort(void)
-{
-    // Configure Port H.0 as input
-    DDRH &= ~(0x01); // Clear bit 0 of DDRH to set PH0 as input
-    
-    // Enable pull-up resistor on Port H.0 if required
-    PERH |= 0x01;    // Set bit 0 of PERH to enable pull-up resistor on PH0
+static unsigned char fieldValue[10];        // BCD accumulators
+static unsigned char parityFlags = 0;       // Running parity, 0 = all groups even
 
-    // Configure Port B.0, B.1, B.2, and B.3 as output for LEDs
-    DDRB |= 0x0F;    // Set lower nibble (bits 0-3) of DDRB to configure PB0-PB3 as output
-}
+// The bits of the current frame are packed into two 32 bit words, split at
+// the parity bit P1, so no BCD field straddles both words. frameMask marks
+// the bits received, frameData those received as 1:
+//   word 0 bit n      = DCF77 bit n       (0 ... 28, minutes + P1)
+//   word 1 bit n - 29 = DCF77 bit n       (29 ... 59, hours ... P3, leap second)
+#define FRAMESPLIT  29
+#define GROUP1      0x1FE00000UL            // Parity groups: word 0 bits 21 ... 28,
+#define GROUP2      0x0000007FUL            // ... word 1 bits 29 ... 35
+#define GROUP3      0x3FFFFF80UL            // ... and 36 ... 58
 
+static unsigned long frameData[2];
+static unsigned long frameMask[2];
 
-// ****************************************************************************
-// Read the hardware port on which the DCF77 signal is connected as input
-// Parameter:   -
-// Returns:     0 if signal is Low, >0 if signal is High
-char readPort(void)
-{
-    // Read the value of Port H.0
-    if (PTH & 0x01) {
-        return 1; // Signal is High
-    } else {
-        return 0; // Signal is Low
-    }
-}
+// Multi-frame voting: the bits of every frame are summed up over consecutive
+// frames as soft decisions in bitVotes (> 0 means 1, < 0 means 0). After each
+// minute the votes of the minute and hour fields are advanced by one minute,
+// so in a weak signal a clean frame builds up from several erroneous ones.
+// Only the bits 21 ... 58 are voted, each vote is a signed nibble.
+#define VOTELIMIT   4                       // Votes saturate, old frames are forgotten
+#define VOTEMARGIN  2                       // Minimum |vote| of every bit of a voted frame
+#define VOTEFIRST   21                      // First bit voted
+#define MAXGAP      360                     // Minutes without marker, after which votes and
+                                            // ... prediction are dropped, see secondsClock()
+
+static const unsigned char fieldFirstBit[10]  = { 0, 21, 29, 36, 42, 45, 50, 28, 35, 58 };
+static const unsigned char fieldParityBit[10] = { 0, 28, 35, 58, 58, 58, 58, 0, 0, 0 };
+
+char dcf77Voting = 1;                       // Multi-frame voting on/off
+static unsigned char bitVotes[(59 - VOTEFIRST + 1) / 2];    // Votes of the previous frames
+static unsigned long markerTime = 0;        // Time of the last minute marker
+static unsigned long markerSecond = 0;      // ... and secondsClock() at that marker
+
+// Prediction: after a valid frame, the next frame is expected to carry the
+// time one minute later. A frame which differs from the expected one in at
+// most one bit per parity group is corrected to it, a valid frame which
+// contradicts it is only accepted, if the following frame confirms it.
+char dcf77Prediction = 1;                   // Prediction on/off
+static char predicted = 0;                  // expectedValue is valid
+static unsigned char expectedValue[10];     // Fields expected in the next frame
+static unsigned long expectedFrame[2];      // ... and its bits 21..58, packed like frameData
+static char candidateValid = 0;             // Unconfirmed time jump in candidateValue
+static unsigned char candidateValue[10];
+
+// Announcements: bits 17 and 18 tell CEST or CET, bit 16 announces the DST
+// changeover and bit 19 a leap second at the end of the hour. These bits have
+// no parity: every valid frame of the hour counts an announcement up if its
+// bit is set and down if not, it is taken at MINANNOUNCE. The changeover is
+// then predicted in the expected frame (hour +1 or -1) and the votes, and
+// the leap second minute may have 60 bits.
+#define MINANNOUNCE 5
+#define MAXANNOUNCE 60
+
+char dcf77Announcements = 1;                // Act on bits 16 and 19 on/off
+static char summerTime = 0;                 // CEST in the expected frame
+static signed char announceDST = 0;        // Up/down count of bit 16 ...
+static signed char announceLeap = 0;        // ... and of bit 19 in this hour
+static char leapMinute = 0;                 // Current minute may have a leap second
+
+// Adaptive classifier: the lengths of the low pulses are collected in a
+// histogram with 10ms bins (in interrupt context, one increment per pulse).
+// After each minute marker a task of the lowest priority splits a copy of it
+// into the "0" and "1" clusters (Otsu's method), the decision threshold lies
+// between their means. The confidence of a bit is its distance to the
+// threshold relative to half the distance of the means, bits below
+// MINCONFIDENCE are invalid. dcf77Confidence is only a diagnostic for the
+// debugger and benchClassify: it is overwritten by the next pulse before the
+// main loop handles the event, so the decoder does not weight bits with it.
+// The nominal second period is tracked as well.
+#define BINS            32                  // Pulses up to 320ms
+#define BINWIDTH        MSEC2TIMER(10)
+#define MINCONFIDENCE   20                  // Percent
+#define MINPULSES       50                  // Pulses needed for a new threshold
+
+char dcf77Adaptive = 1;                     // Adaptive classifier on/off
+unsigned char dcf77Confidence = 0;          // Confidence of the last pulse in percent, diagnostics only
+static unsigned char pulseHistogram[BINS];
+static unsigned int zeroLength = (unsigned int) MSEC2TIMER(100);    // Cluster means
+static unsigned int oneLength  = (unsigned int) MSEC2TIMER(200);
+static unsigned long secondLength = MSEC2TIMER(1000);
+
+// Glitch filter for the sampled signal (DCF77FILTER, see hal.h): an integrator
+// counts up on High and down on Low samples between 0 and dcf77FilterLength.
+// The filtered level only changes when the integrator reaches the opposite
+// limit, so shorter pulses are rejected as glitches (hysteresis).
+unsigned char dcf77FilterLength = 5;        // Samples, i.e. 5ms
+unsigned int dcf77Glitches = 0;             // Rejected glitches
+static unsigned char integrator = 0;
+static char filteredLevel = 0;
+static char excursion = 0;                  // Integrator has left its limit
+
+// Loss of the signal: every edge requests a ticker interrupt SIGNALTIMEOUT
+// later (deadlineTicker(), see ticker.h), longer than the gap before the
+// minute marker. Without an edge up to then, the frame is invalid, so the
+// loss is seen without sampling the signal every 10ms.
+#define SIGNALTIMEOUT   MSEC2TIMER(2500)
+
+static unsigned long signalDeadline = 0;    // Last edge + SIGNALTIMEOUT ...
+static char signalWatched = 0;              // ... not reached yet
+
+// Previous edge: level and time of sampleSignalDCF77() in ms, time of
+// edgeSignalDCF77() in timer counts
+static char sampledSignal = 0;
+static int sampledTime = 0;
+static unsigned long lastEdgeTime = 0;
 
 
 // ****************************************************************************
 //  Initialize DCF77 module
-//  Called once before using the module
+//  Called once before using the module, resets all state of the decoder
+//  except the flags selecting its features
 void initDCF77(void)
-{   
-    
-    setClock((char) dcf77Hour, (char) dcf77Minute, 0);
+{   int i;
+
+    dcf77Year = 2017;
+    dcf77Month = 1;
+    dcf77Day = 1;
+    dcf77Hour = 0;
+    dcf77Minute = 0;
+    dcf77Weekday = 1;
+    frameData[0] = frameData[1] = 0;
+    frameMask[0] = frameMask[1] = 0;
+    for (i = 0; i < (int) sizeof(fieldValue); i++) {
+        fieldValue[i] = 0;
+    }
+    for (i = 0; i < (int) sizeof(bitVotes); i++) {
+        bitVotes[i] = 0;
+    }
+    for (i = 0; i < BINS; i++) {
+        pulseHistogram[i] = 0;
+    }
+    zeroLength = (unsigned int) MSEC2TIMER(100);
+    oneLength = (unsigned int) MSEC2TIMER(200);
+    secondLength = MSEC2TIMER(1000);
+    dcf77Confidence = 0;
+    currentBit = 0;
+    frameError = 0;
+    parityFlags = 0;
+    markerTime = 0;
+    markerSecond = 0;
+    predicted = 0;
+    candidateValid = 0;
+    summerTime = 0;
+    announceDST = 0;
+    announceLeap = 0;
+    leapMinute = 0;
+    integrator = 0;
+    filteredLevel = 0;
+    excursion = 0;
+    dcf77Glitches = 0;
+    signalWatched = 0;
+    sampledSignal = 0;
+    sampledTime = 0;
+    lastEdgeTime = 0;
+    ERROR = 1;
+
+    setDateClock(dcf77Year, (char) dcf77Month, (char) dcf77Day, (char) dcf77Weekday);
+    setClock((char) dcf77Hour, (char) dcf77Minute, 0, localOffsetZone(ZONEDCF77, dateClock(), (char) dcf77Hour));
     displayDateDcf77();
 
     initializePort();
@@ -149,14 +240,183 @@ void initDCF77(void)
 // Parameter:   -
 // Returns:     -
 void displayDateDcf77(void)
-{   char datum[32];
-
-    // update EST time
-    setESTWithDCF77();
+{   char datum[16];
+    const CLOCKDATE *date = dateClock();    // Kept up to date by the clock module
 
-    (void) sprintf(datum, "%s%02d.%02d.%04d%s", EST ? dcf77WeekdayNames[estWeekday-1] : dcf77WeekdayNames[dcf77Weekday-1], EST ? estDay : dcf77Day, EST ? estMonth : dcf77Month, EST ? estYear : dcf77Year, EST ? "US" : "EU");
+    PROFILE_BEGIN(PROFILEDISPLAYDATE);
 
+    formatDate(datum, dcf77WeekdayNames[date->weekday - 1], date->day, date->month, date->year,
+               nameZone(zoneClock()));
     writeLine(datum, 1);
+
+    PROFILE_END(PROFILEDISPLAYDATE);
+}
+
+// *******************************************************************
+// internal function: classifyPulseDCF77 ... Adaptive classification
+// of a low pulse
+// Parameter:  length of the pulse in timer counts
+// Returns:    VALIDZERO, VALIDONE or INVALID
+// Note:       Runs in interrupt context with input capture
+static DCF77EVENT classifyPulseDCF77(unsigned long length)
+{
+    unsigned char bin;
+    unsigned int threshold, half;
+    unsigned long distance;
+
+    dcf77Confidence = 0;
+    if (length < BINS * BINWIDTH) {
+        bin = (unsigned char) (length / BINWIDTH);
+        if (++pulseHistogram[bin] == 255) {     // Forget old pulses
+            for (bin = 0; bin < BINS; bin++) {
+                pulseHistogram[bin] >>= 1;
+            }
+        }
+    }
+
+    half = (oneLength - zeroLength) / 2;
+    threshold = zeroLength + half;
+    if (length + half < zeroLength || length > oneLength + half) {
+        return INVALID;
+    }
+    distance = length < threshold ? threshold - length : length - threshold;
+    dcf77Confidence = (unsigned char) (distance >= half ? 100 : distance * 100 / half);
+    if (dcf77Confidence < MINCONFIDENCE) {
+        return INVALID;
+    }
+    return length < threshold ? VALIDZERO : VALIDONE;
+}
+
+// *******************************************************************
+// internal function: classifyPeriodDCF77 ... Adaptive classification
+// of the time between two falling edges
+// Parameter:  length of the period in timer counts
+// Returns:    VALIDSECOND, VALIDMINUTE or INVALID
+// Note:       Runs in interrupt context with input capture
+static DCF77EVENT classifyPeriodDCF77(unsigned long length)
+{
+    if (length + MSEC2TIMER(300) >= secondLength && length <= secondLength + MSEC2TIMER(300)) {
+        secondLength = secondLength - secondLength / 16 + length / 16;
+        if (secondLength < MSEC2TIMER(950)) {
+            secondLength = MSEC2TIMER(950);
+        } else if (secondLength > MSEC2TIMER(1050)) {
+            secondLength = MSEC2TIMER(1050);
+        }
+        return VALIDSECOND;
+    }
+    if (length + MSEC2TIMER(300) >= 2 * secondLength && length <= 2 * secondLength + MSEC2TIMER(300)) {
+        return VALIDMINUTE;
+    }
+    return INVALID;
+}
+
+// *******************************************************************
+// Public function: adaptClassifierDCF77 ... Find the "0" and "1"
+// clusters in the histogram of the pulse lengths
+// Parameter:   -
+// Returns:     -
+// Note:        Called by the main loop after a minute marker, when the
+//              clock has been set (see task.c). The histogram is copied
+//              and the new means are set with the interrupts disabled,
+//              as classifyPulseDCF77() uses them in interrupt context.
+//              The clusters are only taken, when they are plausible.
+void adaptClassifierDCF77(void)
+{
+    unsigned char histogram[BINS];
+    unsigned int n = 0, n0 = 0, n1, k, best = 0;
+    unsigned long sum = 0, sum0 = 0, score, bestScore = 0;
+    unsigned int mean0 = 0, mean1 = 0, diff;    // In 1/16 bins
+
+    disableIRQ();
+    for (k = 0; k < BINS; k++) {
+        histogram[k] = pulseHistogram[k];
+    }
+    enableIRQ();
+
+    for (k = 0; k < BINS; k++) {
+        n += histogram[k];
+        sum += (unsigned long) histogram[k] * k;
+    }
+    if (n < MINPULSES) {
+        return;
+    }
+
+    for (k = 1; k < BINS; k++) {            // Split between bin k-1 and k
+        n0 += histogram[k - 1];
+        sum0 += (unsigned long) histogram[k - 1] * (k - 1);
+        n1 = n - n0;
+        if (n0 == 0 || n1 == 0) {
+            continue;
+        }
+        diff = (unsigned int) ((sum - sum0) * 16 / n1 - sum0 * 16 / n0);
+        score = (unsigned long) n0 * n1 / n * diff * diff;  // Between-class variance
+        if (score > bestScore) {
+            bestScore = score;
+            best = k;
+            mean0 = (unsigned int) (sum0 * 16 / n0);
+            mean1 = (unsigned int) ((sum - sum0) * 16 / n1);
+        }
+    }
+
+    // Bin k covers k*10ms ... k*10ms+10ms, its center is at k*10ms+5ms
+    if (best == 0 || mean1 - mean0 < 5 * 16 || mean0 < 3 * 16 || mean1 > 30 * 16) {
+        return;                             // Less than 50ms apart, or out of range
+    }
+    disableIRQ();
+    zeroLength = (unsigned int) ((unsigned long) mean0 * BINWIDTH / 16 + BINWIDTH / 2);
+    oneLength  = (unsigned int) ((unsigned long) mean1 * BINWIDTH / 16 + BINWIDTH / 2);
+    enableIRQ();
+}
+
+// *******************************************************************
+// internal function: classifyDCF77 ... Classify the pulse ending
+// with an edge of the DCF77 signal
+// Parameter:  Signal level after the edge, time since the previous
+//             edge in timer counts
+// Returns:    DCF77 event, i.e. second pulse, 0 or 1 data 
+//             bit, minute marker or invalid
+// Note:       The function will toggle LED B.1 on every edge
+static DCF77EVENT classifyDCF77(char signal, unsigned long length)
+{
+    DCF77EVENT event;
+
+    if (dcf77Adaptive) {
+        event = signal == 0 ? classifyPeriodDCF77(length) : classifyPulseDCF77(length);
+    } else if (signal == 0) {
+        // Falling edge: length of the whole second
+        if (length >= MSEC2TIMER(700) && length <= MSEC2TIMER(1300)) {
+            event = VALIDSECOND;
+        } else if (length >= MSEC2TIMER(1700) && length <= MSEC2TIMER(2300)) {
+            event = VALIDMINUTE;
+        } else {
+            event = INVALID;
+        }
+    } else {
+        // Rising edge: length of the low pulse
+        if (length >= MSEC2TIMER(70) && length <= MSEC2TIMER(130)) {
+            event = VALIDZERO;
+        } else if (length >= MSEC2TIMER(170) && length <= MSEC2TIMER(230)) {
+            event = VALIDONE;
+        } else {
+            event = INVALID;
+        }
+    }
+
+    toggleLED(0x02); // Toggle LED B.1
+    return event;
+}
+
+// *******************************************************************
+// internal function: watchSignalDCF77 ... Restart the timeout of the
+// signal on an edge
+// Parameter:  Time of the edge in timer counts
+// Returns:    -
+// Note:       Runs in interrupt context
+static void watchSignalDCF77(unsigned long edgeTime)
+{
+    signalDeadline = edgeTime + SIGNALTIMEOUT;
+    signalWatched = 1;
+    deadlineTicker(signalDeadline);
 }
 
 // *******************************************************************
@@ -165,51 +425,596 @@ void displayDateDcf77(void)
 // Parameter:  Current CPU time base in milliseconds
 // Returns:    DCF77 event, i.e. second pulse, 0 or 1 data 
 //             bit or minute marker
-// Note:       Must be called by user every 10ms
+// Note:       Must be called by user every 10ms, when the
+//             signal is polled (DCF77CAPTURE not defined)
 //             If the signal is low, the function will toggle LED B.1
 DCF77EVENT sampleSignalDCF77(int currentTime)
 {
-    static char lastSignal = 0;
-    static int lastTime = 0;
     DCF77EVENT event = NODCF77EVENT;
 
     char signal = readPort();  // Read current signal state
 
     // Detect edges and measure pulse lengths
-    if (signal != lastSignal) {
-        if (signal == 0) {
-            // Falling edge detected
-            int pulseLength = currentTime - lastTime;
-            if (pulseLength >= 700 && pulseLength <= 1300) {
-                event = VALIDSECOND;
-            } else if (pulseLength >= 1700 && pulseLength <= 2300) {
-                event = VALIDMINUTE;
+    if (signal != sampledSignal) {
+        event = classifyDCF77(signal, MSEC2TIMER(currentTime - sampledTime));
+        sampledTime = currentTime;
+        sampledSignal = signal;
+        watchSignalDCF77(tickerTime);
+    }
+
+    return event;
+}
+
+// *******************************************************************
+// Public function: edgeSignalDCF77 ... Evaluate a timestamped edge
+// of the DCF77 signal and detect events
+// Parameter:  Time of the edge in timer counts (see ticker.h),
+//             signal level after the edge
+// Returns:    DCF77 event, i.e. second pulse, 0 or 1 data 
+//             bit or minute marker
+// Note:       Called by captureDCF77() on the target, the host
+//             build may feed recorded edges directly.
+DCF77EVENT edgeSignalDCF77(unsigned long edgeTime, char signal)
+{
+    DCF77EVENT event = classifyDCF77(signal, edgeTime - lastEdgeTime);
+
+    lastEdgeTime = edgeTime;
+    watchSignalDCF77(edgeTime);
+    return event;
+}
+
+// *******************************************************************
+// Public function: timeoutDCF77 ... Detect the loss of the signal
+// Parameter:  Current time in timer counts
+// Returns:    1 once, when no edge came within SIGNALTIMEOUT of the
+//             last one, else 0
+// Note:       Called by tick10ms() in interrupt context, the caller
+//             posts INVALID for the frame.
+char timeoutDCF77(unsigned long time)
+{
+    if (!signalWatched) {
+        return 0;
+    }
+    if ((long) (time - signalDeadline) < 0) {
+        deadlineTicker(signalDeadline);     // Renew the request
+        return 0;
+    }
+    signalWatched = 0;
+    return 1;
+}
+
+// *******************************************************************
+// Public function: captureDCF77 ... Callback of the input capture ISR
+// Parameter:  16 bit timer value latched on the edge, signal level
+//             after the edge, i.e. the polarity of the captured edge
+// Returns:    -
+// Note:       Runs in interrupt context. The timestamp is extended
+//             to 32 bit with the time base of the ticker, which
+//             never lags more than MAXTICKERTICKS ticks behind.
+//             The level comes from the edge armed in capture.asm,
+//             the pin may already have changed again.
+void captureDCF77(unsigned int captureTime, char level)
+{
+    unsigned long edgeTime;
+
+    enterISRLoad();
+    PROFILE_BEGIN(PROFILECAPTURE);
+    edgeTime = tickerTime + (long) (short) (captureTime - tickerTC);
+    postEvent(DCF77SOURCE, edgeSignalDCF77(edgeTime, level), edgeTime);
+    PROFILE_END(PROFILECAPTURE);
+    leaveISRLoad();
+}
+
+// *******************************************************************
+// Public function: filterDCF77 ... Callback of the sampling ISR
+// Parameter:  16 bit timer value of the sample, signal level
+// Returns:    -
+// Note:       Runs in interrupt context every sample period, the
+//             work beyond the integrator is done on edges only.
+//             The filtered edges lag dcf77FilterLength samples
+//             behind, which does not change the pulse lengths.
+void filterDCF77(unsigned int sampleTime, char level)
+{
+    unsigned long edgeTime;
+
+    enterISRLoad();
+    PROFILE_BEGIN(PROFILEFILTER);
+    if (level) {
+        if (integrator < dcf77FilterLength) {
+            integrator++;
+        }
+    } else if (integrator > 0) {
+        integrator--;
+    }
+
+    if (integrator == (filteredLevel ? dcf77FilterLength : 0)) {
+        if (excursion) {                    // Back without an edge: glitch
+            dcf77Glitches++;
+            excursion = 0;
+        }
+    } else if (integrator == (filteredLevel ? 0 : dcf77FilterLength)) {
+        filteredLevel = (char) !filteredLevel;
+        excursion = 0;
+        edgeTime = tickerTime + (long) (short) (sampleTime - tickerTC);
+        postEvent(DCF77SOURCE, edgeSignalDCF77(edgeTime, filteredLevel), edgeTime);
+    } else {
+        excursion = 1;
+    }
+    PROFILE_END(PROFILEFILTER);
+    leaveISRLoad();
+}
+
+// *******************************************************************
+// internal function: frameBitDCF77 ... Bit of the current frame
+// Parameter:   bit position 0 ... 59
+// Returns:     1 if received as 1, -1 if received as 0, 0 if missing
+static signed char frameBitDCF77(int bit)
+{
+    unsigned char word = (unsigned char) (bit >= FRAMESPLIT);
+    unsigned long mask = 1UL << (word ? bit - FRAMESPLIT : bit);
+
+    if (!(frameMask[word] & mask)) {
+        return 0;
+    }
+    return (signed char) (frameData[word] & mask ? 1 : -1);
+}
+
+// *******************************************************************
+// internal function: voteDCF77 ... Vote of a bit
+// Parameter:   bit position VOTEFIRST ... 58
+// Returns:     vote -VOTELIMIT ... VOTELIMIT
+static signed char voteDCF77(int bit)
+{
+    unsigned char n = bitVotes[(bit - VOTEFIRST) >> 1];
+
+    if ((bit - VOTEFIRST) & 1) {
+        n >>= 4;
+    }
+    n &= 0x0F;
+    return (signed char) (n >= 8 ? n - 16 : n);
+}
+
+// *******************************************************************
+// internal function: setVoteDCF77 ... Change the vote of a bit
+// Parameter:   bit position VOTEFIRST ... 58, vote -VOTELIMIT ... VOTELIMIT
+// Returns:     -
+static void setVoteDCF77(int bit, signed char vote)
+{
+    unsigned char *votes = &bitVotes[(bit - VOTEFIRST) >> 1];
+
+    if ((bit - VOTEFIRST) & 1) {
+        *votes = (unsigned char) ((*votes & 0x0F) | ((vote & 0x0F) << 4));
+    } else {
+        *votes = (unsigned char) ((*votes & 0xF0) | (vote & 0x0F));
+    }
+}
+
+// *******************************************************************
+// internal function: streamBitDCF77 ... Account for a received data bit
+// Parameter:   bit value (0 or 1), its position is currentBit
+// Returns:     -
+// Note:        When the last bit of a field has arrived, its range is
+//              checked right away and an invalid field aborts the frame.
+static void streamBitDCF77(char value)
+{
+    unsigned char field  = bitField[currentBit];
+    unsigned char weight = bitWeight[currentBit];
+
+    if (weight == 1) {                      // First bit of a BCD field
+        fieldValue[field] = 0;
+    }
+    if (value) {
+        fieldValue[field] += weight;
+        parityFlags ^= fieldParity[field];
+    }
+    if (currentBit == fieldLastBit[field] &&
+        (fieldValue[field] < fieldMin[field] || fieldValue[field] > fieldMax[field])) {
+        frameError = 1;
+        ERROR = 1;
+    }
+}
+
+// *******************************************************************
+// internal function: startFrameDCF77 ... Reset the decoder for the
+// next frame
+// Parameter:   -
+// Returns:     -
+static void startFrameDCF77(void)
+{
+    frameData[0] = frameData[1] = 0;
+    frameMask[0] = frameMask[1] = 0;
+    currentBit = 0;
+    frameError = 0;
+    parityFlags = 0;
+}
+
+// *******************************************************************
+// internal function: votedFieldDCF77 ... Value of a field according
+// to the votes, bits without votes count as 0
+// Parameter:   field
+// Returns:     field value
+static int votedFieldDCF77(DCF77FIELD field)
+{
+    int i, value = 0;
+
+    for (i = fieldFirstBit[field]; i <= fieldLastBit[field]; i++) {
+        if (voteDCF77(i) > 0) {
+            value += bitWeight[i];
+        }
+    }
+    return value;
+}
+
+// *******************************************************************
+// internal function: bcdBitDCF77 ... Bit of a value in BCD
+// Parameter:   value, weight of the bit (1, 2, 4, 8, 10, 20, 40 or 80)
+// Returns:     1 if the bit is set, otherwise 0
+static char bcdBitDCF77(int value, unsigned char weight)
+{
+    if (weight < 10) {
+        return (char) ((value % 10 & weight) != 0);
+    }
+    return (char) ((value / 10 & weight / 10) != 0);
+}
+
+// *******************************************************************
+// internal function: advanceFieldDCF77 ... Change the votes of a field
+// from one value to another and keep its parity bit consistent
+// Parameter:   field, value the votes stand for, new value
+// Returns:     -
+// Note:        The votes of the bits which differ in BCD change their
+//              sign, so the confidence built up is kept.
+static void advanceFieldDCF77(DCF77FIELD field, int from, int to)
+{
+    int i;
+
+    for (i = fieldFirstBit[field]; i <= fieldLastBit[field]; i++) {
+        if (bcdBitDCF77(from, bitWeight[i]) != bcdBitDCF77(to, bitWeight[i])) {
+            setVoteDCF77(i, (signed char) -voteDCF77(i));
+            setVoteDCF77(fieldParityBit[field], (signed char) -voteDCF77(fieldParityBit[field]));
+        }
+    }
+}
+
+// *******************************************************************
+// internal function: clearVotesDCF77 ... Forget the votes of some bits
+// Parameter:   first and last bit
+// Returns:     -
+static void clearVotesDCF77(int first, int last)
+{
+    for (; first <= last; first++) {
+        setVoteDCF77(first, 0);
+    }
+}
+
+// *******************************************************************
+// internal function: advanceVotesDCF77 ... Turn the votes into the
+// expected frame of the next minute
+// Parameter:   hours added at the next full hour for the DST changeover
+// Returns:     -
+// Note:        Minute, hour, day and weekday are advanced. The end
+//              of a month is not predicted, the votes of the date are
+//              cleared instead, as are the votes of an invalid field.
+static void advanceVotesDCF77(signed char change)
+{
+    int minute  = votedFieldDCF77(MINUTE);
+    int hour    = votedFieldDCF77(HOUR);
+    int day     = votedFieldDCF77(DAY);
+    int weekday = votedFieldDCF77(WEEKDAY);
+
+    if (minute > 59) {
+        clearVotesDCF77(21, 28);
+        return;
+    }
+    advanceFieldDCF77(MINUTE, minute, minute < 59 ? minute + 1 : 0);
+    if (minute < 59) {
+        return;
+    }
+    if (hour > 23) {
+        clearVotesDCF77(29, 35);
+        return;
+    }
+    advanceFieldDCF77(HOUR, hour, hour < 23 ? hour + 1 + change : 0);
+    if (hour < 23) {
+        return;
+    }
+    if (day >= 1 && day < 28 && weekday >= 1 && weekday <= 7) {
+        advanceFieldDCF77(DAY, day, day + 1);
+        advanceFieldDCF77(WEEKDAY, weekday, weekday < 7 ? weekday + 1 : 1);
+    } else {
+        clearVotesDCF77(36, 58);
+    }
+}
+
+// *******************************************************************
+// internal function: addVotesDCF77 ... Add the frame just received
+// to the votes
+// Parameter:   -
+// Returns:     -
+// Note:        Called at the minute marker, currentBit is still the
+//              position of the last bit received. Only frames in sync
+//              are counted.
+static void addVotesDCF77(void)
+{
+    int i;
+    unsigned char word = 0;
+    unsigned long mask = 1UL << VOTEFIRST;
+    signed char vote;
+
+    if (currentBit != 58) {
+        return;
+    }
+    for (i = VOTEFIRST; i <= 58; i++) {
+        if (i == FRAMESPLIT) {
+            word = 1;
+            mask = 1;
+        }
+        vote = voteDCF77(i);
+        if (frameMask[word] & mask) {
+            if (frameData[word] & mask) {
+                vote = (signed char) (vote < VOTELIMIT ? vote + 1 : VOTELIMIT);
             } else {
-                event = INVALID;
+                vote = (signed char) (vote > -VOTELIMIT ? vote - 1 : -VOTELIMIT);
             }
+            setVoteDCF77(i, vote);
+        }
+        mask <<= 1;
+    }
+}
+
+// *******************************************************************
+// internal function: replayVotesDCF77 ... Decode the voted frame
+// Parameter:   -
+// Returns:     error flag, 0 if fieldValue holds a valid frame
+static char replayVotesDCF77(void)
+{
+    signed char vote;
+
+    frameError = 0;
+    parityFlags = 0;
+    for (currentBit = VOTEFIRST; currentBit <= 58 && !frameError; currentBit++) {
+        vote = voteDCF77(currentBit);
+        if (vote < VOTEMARGIN && vote > -VOTEMARGIN) {
+            frameError = 1;
         } else {
-            // Rising edge detected
-            int lowLength = currentTime - lastTime;
-            if (lowLength >= 70 && lowLength <= 130) {
-                event = VALIDZERO;
-            } else if (lowLength >= 170 && lowLength <= 230) {
-                event = VALIDONE;
-            } else {
-                event = INVALID;
-            }
+            streamBitDCF77((char) (vote > 0));
         }
-        lastTime = currentTime;
-        lastSignal = signal;
-    } else {
-        event = NODCF77EVENT;
     }
+    return (char) (frameError || parityFlags != 0);
+}
+
+// *******************************************************************
+// internal function: nextMinuteDCF77 ... Advance the fields of a
+// frame by one minute
+// Parameter:   field values, hours added at the next full hour for the
+//              DST changeover (never at midnight)
+// Returns:     -
+static void nextMinuteDCF77(unsigned char *value, signed char change)
+{
+    int days;
+
+    if (++value[MINUTE] < 60) {
+        return;
+    }
+    value[MINUTE] = 0;
+    value[HOUR] = (unsigned char) (value[HOUR] + change);
+    if (++value[HOUR] < 24) {
+        return;
+    }
+    value[HOUR] = 0;
+    value[WEEKDAY] = (unsigned char) (value[WEEKDAY] % 7 + 1);
+    days = monthDays[value[MONTH] - 1];
+    if (value[MONTH] == 2 && value[YEAR] % 4 == 0) {    // 2000 ... 2099
+        days = 29;
+    }
+    if (++value[DAY] <= days) {
+        return;
+    }
+    value[DAY] = 1;
+    if (++value[MONTH] <= 12) {
+        return;
+    }
+    value[MONTH] = 1;
+    value[YEAR] = (unsigned char) ((value[YEAR] + 1) % 100);
+}
 
-    // Toggle LED B.1 when the signal is low
-    if (event != NODCF77EVENT) {
-        PORTB ^= 0x02; // Toggle LED B.1
+// *******************************************************************
+// internal function: predictFrameDCF77 ... Encode the bits of the
+// expected frame
+// Parameter:   -
+// Returns:     -
+static void predictFrameDCF77(void)
+{
+    int i;
+    unsigned char field, bit, parity = 0, word = 0;
+    unsigned long mask = 1UL << 21;
+
+    expectedFrame[0] = expectedFrame[1] = 0;
+    for (i = 21; i <= 58; i++) {
+        if (i == FRAMESPLIT) {
+            word = 1;
+            mask = 1;
+        }
+        field = bitField[i];
+        if (bitWeight[i]) {
+            bit = (unsigned char) bcdBitDCF77(expectedValue[field], bitWeight[i]);
+        } else {                            // Parity bit, makes its group even
+            bit = (unsigned char) (parity & fieldParity[field]);
+        }
+        if (bit) {
+            expectedFrame[word] |= mask;
+            parity ^= fieldParity[field];
+        }
+        mask <<= 1;
     }
+}
 
-    return event;
+// *******************************************************************
+// internal function: correctFrameDCF77 ... Correct the frame just
+// received with the expected frame
+// Parameter:   -
+// Returns:     error flag, 0 if fieldValue holds the corrected frame
+// Note:        A parity group may contain one bad bit, i.e. a missing
+//              bit or one which differs from the expected frame; a
+//              single flipped bit always fails the parity check.
+static char correctFrameDCF77(void)
+{
+    int i;
+    unsigned long bad0 = ((frameData[0] ^ expectedFrame[0]) | ~frameMask[0]) & GROUP1;
+    unsigned long bad1 = (frameData[1] ^ expectedFrame[1]) | ~frameMask[1];
+    unsigned long bad2 = bad1 & GROUP2, bad3 = bad1 & GROUP3;
+
+    if ((bad0 & (bad0 - 1)) || (bad2 & (bad2 - 1)) || (bad3 & (bad3 - 1))) {
+        return 1;                           // Two bad bits in a group
+    }
+    for (i = MINUTE; i <= YEAR; i++) {
+        fieldValue[i] = expectedValue[i];
+    }
+    return 0;
+}
+
+// *******************************************************************
+// internal function: sameTimeDCF77 ... Compare the decoded frame
+// Parameter:   field values to compare with
+// Returns:     1 if fieldValue holds the same time and date
+static char sameTimeDCF77(const unsigned char *value)
+{
+    int i;
+
+    for (i = MINUTE; i <= YEAR; i++) {
+        if (fieldValue[i] != value[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// *******************************************************************
+// internal function: contradictsDCF77 ... Check a valid frame
+// against the expected frame
+// Parameter:   -
+// Returns:     1 if the frame is to be rejected
+// Note:        A time jump is accepted, when the following frame
+//              confirms it.
+static char contradictsDCF77(void)
+{
+    int i;
+
+    if (sameTimeDCF77(expectedValue) || (candidateValid && sameTimeDCF77(candidateValue))) {
+        return 0;
+    }
+    for (i = MINUTE; i <= YEAR; i++) {
+        candidateValue[i] = fieldValue[i];
+    }
+    candidateValid = 1;
+    return 1;
+}
+
+// *******************************************************************
+// internal function: minutePassedDCF77 ... Prepare the votes and the
+// expected frames for the next minute
+// Parameter:   -
+// Returns:     -
+// Note:        Called at every minute marker and once more for every
+//              minute passed without a marker.
+static void minutePassedDCF77(void)
+{
+    signed char change = 0;
+
+    if (announceDST >= MINANNOUNCE) {       // CEST -> CET or CET -> CEST
+        change = (signed char) (summerTime ? -1 : 1);
+    }
+    if (dcf77Voting) {
+        advanceVotesDCF77(change);
+    }
+    leapMinute = 0;
+    if (predicted) {
+        nextMinuteDCF77(expectedValue, change);
+        predictFrameDCF77();
+        if (expectedValue[MINUTE] == 0) {   // Last minute of the hour starts
+            leapMinute = (char) (announceLeap >= MINANNOUNCE);
+            summerTime = (char) (summerTime ^ (change != 0));
+            announceDST = 0;
+            announceLeap = 0;
+        }
+    }
+    if (candidateValid) {
+        nextMinuteDCF77(candidateValue, change);
+    }
+}
+
+// *******************************************************************
+// internal function: countDCF77 ... Count an announcement bit up or
+// down
+// Parameter:   counter, bit
+// Returns:     new count
+static signed char countDCF77(signed char count, signed char bit)
+{
+    if (bit > 0 && count < MAXANNOUNCE) {
+        count++;
+    } else if (bit <= 0 && count > 0) {
+        count--;
+    }
+    return count;
+}
+
+// *******************************************************************
+// internal function: announcementsDCF77 ... Decode bits 16 ... 19 of
+// a valid frame
+// Parameter:   -
+// Returns:     offset of the time of the frame to UTC in minutes,
+//              -1 if it is to be taken from the EU DST rule
+// Note:        Called before the frame becomes the expected one. A
+//              frame as expected keeps the zone of the expectation,
+//              otherwise a valid CEST/CET pair confirms it. A zone
+//              change without announcement must match the DST rule, so
+//              two flipped bits do not shift the time.
+static int announcementsDCF77(void)
+{
+    int offset = -1;
+    signed char cest = frameBitDCF77(17), cet = frameBitDCF77(18);
+
+    if ((predicted && sameTimeDCF77(expectedValue))
+        || (cest != 0 && cet != 0 && (cest > 0) != (cet > 0) && (cest > 0) == summerTime)) {
+        offset = summerTime ? 120 : 60;
+    }
+    if (fieldValue[MINUTE] == 0) {          // New hour, forget the announcements
+        announceDST = 0;
+        announceLeap = 0;
+    }
+    if (dcf77Announcements) {
+        announceDST = countDCF77(announceDST, frameBitDCF77(16));
+        announceLeap = countDCF77(announceLeap, frameBitDCF77(19));
+    }
+    return offset;
+}
+
+// *******************************************************************
+// internal function: commitFrameDCF77 ... Set the clock to the frame
+// decoded in fieldValue
+// Parameter:   -
+// Returns:     -
+// Note:        Called before the frame becomes the expected one, the
+//              votes and the expectation are updated afterwards.
+static void commitFrameDCF77(void)
+{
+    int offset;
+
+    dcf77Minute  = fieldValue[MINUTE];
+    dcf77Hour    = fieldValue[HOUR];
+    dcf77Day     = fieldValue[DAY];
+    dcf77Weekday = fieldValue[WEEKDAY];
+    dcf77Month   = fieldValue[MONTH];
+    dcf77Year    = fieldValue[YEAR] + 2000;
+    offset = announcementsDCF77();
+
+    // Discipline the clock, it keeps the date and converts to the selected zone
+    setDateClock(dcf77Year, (char) dcf77Month, (char) dcf77Day, (char) dcf77Weekday);
+    if (offset < 0) {
+        offset = localOffsetZone(ZONEDCF77, dateClock(), (char) dcf77Hour);
+        summerTime = (char) (offset > 60);
+    }
+    setClock((char) dcf77Hour, (char) dcf77Minute, 0, offset);
 }
 
 // ********************************************************************
@@ -217,165 +1022,132 @@ DCF77EVENT sampleSignalDCF77(int currentTime)
 // events and decode the time and date
 
 // Contains the DCF77 state machine
-// Parameter:   Result of sampleSignalDCF77 as parameter
+// Parameter:   Result of sampleSignalDCF77 or edgeSignalDCF77,
+//              time of the event in timer counts (see ticker.h)
 // Returns:     -
 // Note:        Must be called by user after sampleSignalDCF77().
 //              On error (Invalid data or parity) the error flag is set
 //              and the error LED B.2 is turned on and the time and date 
-//              is not updated.
+//              is not updated. With dcf77Voting set, a frame with errors
+//              is added to the votes of the previous frames and the
+//              voted frame is used, if it is valid. With dcf77Prediction
+//              set, frames are checked against the previous valid frame
+//              plus one minute and single bit errors are corrected.
+//              With dcf77Announcements set, an announced DST changeover
+//              and leap second are expected in the following frames.
 //              On valid data the error flag is cleared and 
 //              the error LED B.2 is turned off, 
 //              LED B.3 is turned on and the time and date is updated
-//              It also uses the EST flag to correctly display 
-//              the time for the European and US time zones.
-void processEventsDCF77(DCF77EVENT event)
+//              The clock converts the time to the selected zone.
+void processEventsDCF77(DCF77EVENT event, unsigned long eventTime)
 {
-// --- Add your code here ----------------------------------------------------
+    int i;
+    char received;
+    unsigned char word;
+    unsigned long mask, minutes;
+
+    PROFILE_BEGIN(PROFILEDCF77);
+
     switch (event)
     {
     case VALIDSECOND:
+        syncClock(eventTime);               // Align the local second
         currentBit++;
-        if (currentBit > 58)
+        if (currentBit == 59 && leapMinute) {
+            leapSecondClock();              // Second 59 is the leap second
+        } else if (currentBit > 58)
         {
-            currentBit = 0;
+            startFrameDCF77();
+            frameError = 1;                 // Frame is lost, wait for the next minute marker
             ERROR = 1;
         }
         break;
     case VALIDZERO:
-        dcf77Buffer[currentBit] = 0;
-        break;
     case VALIDONE:
-        dcf77Buffer[currentBit] = 1;
+        word = (unsigned char) (currentBit >= FRAMESPLIT);
+        mask = 1UL << (word ? currentBit - FRAMESPLIT : currentBit);
+        if (frameMask[word] & mask) {       // Two bits in one second
+            frameError = 1;
+        }
+        frameMask[word] |= mask;
+        if (event == VALIDONE) {
+            frameData[word] |= mask;
+        } else {
+            frameData[word] &= ~mask;
+        }
+        if (currentBit < 59) {
+            streamBitDCF77((char) (event == VALIDONE));
+        }
         break;
     case VALIDMINUTE:
-        if (currentBit == 58) {
-            currentBit = 0;
-            // check parity
-            // 21 - 27
-            paritySum = 0;
-            for (i = 21; i <= 28; i++) {
-                paritySum += dcf77Buffer[i];
-            }
-            if (paritySum % 2 != 0) {
-                ERROR = 1;
-                break;
-            }
-            // 29 - 34
-            paritySum = 0;
-            for (i = 29; i <= 35; i++) {
-                paritySum += dcf77Buffer[i];
-            }
-            if (paritySum % 2 != 0) {
-                ERROR = 1;
-                break;
-            }
-            // 36 - 57
-            paritySum = 0;
-            for (i = 36; i <= 58; i++) {
-                paritySum += dcf77Buffer[i];
-            }
-            if (paritySum % 2 != 0) {
-                ERROR = 1;
-                break;
-            }
-            // decode minutes
-            dcf77Minute = 0;
-            dcf77Minute += dcf77Buffer[21] * 1;
-            dcf77Minute += dcf77Buffer[22] * 2;
-            dcf77Minute += dcf77Buffer[23] * 4;
-            dcf77Minute += dcf77Buffer[24] * 8;
-            dcf77Minute += dcf77Buffer[25] * 10;
-            dcf77Minute += dcf77Buffer[26] * 20;
-            dcf77Minute += dcf77Buffer[27] * 40;
-            // check if minutes are valid
-            if (dcf77Minute > 59) {
-                ERROR = 1;
-                break;
-            }
-
-            // decode hours
-            dcf77Hour = 0;
-            dcf77Hour += dcf77Buffer[29] * 1;
-            dcf77Hour += dcf77Buffer[30] * 2;
-            dcf77Hour += dcf77Buffer[31] * 4;
-            dcf77Hour += dcf77Buffer[32] * 8;
-            dcf77Hour += dcf77Buffer[33] * 10;
-            dcf77Hour += dcf77Buffer[34] * 20;
-            // check if hours are valid
-            if (dcf77Hour > 23) {
-                ERROR = 1;
-                break;
+        // Minutes since the previous marker, catch up with those without
+        // marker. The 32 bit timer counts wrap after 381 minutes (masked, so
+        // the host computes the same), a longer gap is only seen in the
+        // second ticks of the clock and drops votes and prediction.
+        minutes = (((eventTime - markerTime) & 0xFFFFFFFFUL) + MSEC2TIMER(30000)) / MSEC2TIMER(60000);
+        if (minutes == 0) {                 // Second marker within a minute
+            startFrameDCF77();
+            ERROR = 1;
+            break;
+        }
+        markerTime = eventTime;
+        syncClock(eventTime);
+        if (minutes > MAXGAP || secondsClock() - markerSecond > MAXGAP * 60UL + 30) {
+            clearVotesDCF77(VOTEFIRST, 58);
+            predicted = 0;
+            candidateValid = 0;
+        } else {
+            for (; minutes > 1; minutes--) {
+                minutePassedDCF77();
             }
-
-            // decode day
-            dcf77Day = 0;
-            dcf77Day += dcf77Buffer[36] * 1;
-            dcf77Day += dcf77Buffer[37] * 2;
-            dcf77Day += dcf77Buffer[38] * 4;
-            dcf77Day += dcf77Buffer[39] * 8;
-            dcf77Day += dcf77Buffer[40] * 10;
-            dcf77Day += dcf77Buffer[41] * 20;
-            // check if day is valid
-            if (dcf77Day > 31 || dcf77Day == 0) {
-                ERROR = 1;
-                break;
+        }
+        markerSecond = secondsClock();
+        if (currentBit == 59 && leapMinute) {   // 60 bits, the leap second is a 0
+            currentBit = 58;
+            if (frameBitDCF77(59) > 0) {
+                frameError = 1;
             }
+        }
 
-            // decode weekday
-            dcf77Weekday = 0;
-            dcf77Weekday += dcf77Buffer[42] * 1;
-            dcf77Weekday += dcf77Buffer[43] * 2;
-            dcf77Weekday += dcf77Buffer[44] * 4;
-            // check if weekday is valid
-            if (dcf77Weekday > 7 || dcf77Weekday == 0) {
-                ERROR = 1;
-                break;
+        // A frame valid as received only needs the three parity flags and
+        // the prediction, the clock is set before the bookkeeping below.
+        ERROR = (char) (currentBit != 58 || frameError || parityFlags != 0);
+        received = (char) !ERROR;
+        if (ERROR) {
+            if (predicted && currentBit == 58) {
+                ERROR = correctFrameDCF77();
             }
-
-            // decode month
-            dcf77Month = 0;
-            dcf77Month += dcf77Buffer[45] * 1;
-            dcf77Month += dcf77Buffer[46] * 2;
-            dcf77Month += dcf77Buffer[47] * 4;
-            dcf77Month += dcf77Buffer[48] * 8;
-            dcf77Month += dcf77Buffer[49] * 10;
-            // check if month is valid
-            if (dcf77Month > 12 || dcf77Month == 0) {
-                ERROR = 1;
-                break;
+            if (dcf77Voting) {
+                addVotesDCF77();
+                if (ERROR) {
+                    ERROR = replayVotesDCF77();
+                }
             }
+        }
+        if (ERROR == 0 && predicted) {
+            ERROR = contradictsDCF77();
+        }
+        if (ERROR == 0) {
+            commitFrameDCF77();
+        }
 
-            // decode year
-            dcf77Year = 0;
-            dcf77Year += dcf77Buffer[50] * 1;
-            dcf77Year += dcf77Buffer[51] * 2;
-            dcf77Year += dcf77Buffer[52] * 4;
-            dcf77Year += dcf77Buffer[53] * 8;
-            dcf77Year += dcf77Buffer[54] * 10;
-            dcf77Year += dcf77Buffer[55] * 20;
-            dcf77Year += dcf77Buffer[56] * 40;
-            dcf77Year += dcf77Buffer[57] * 80;
-            dcf77Year += 2000;
-            // check if year is valid
-            if (dcf77Year > 2099) {
-                ERROR = 1;
-                break;
+        // Bookkeeping for the next frame
+        if (received && dcf77Voting) {
+            addVotesDCF77();
+        }
+        if (ERROR == 0) {
+            trimClock(eventTime, dcf77Hour * 60 + dcf77Minute);
+            for (i = MINUTE; i <= YEAR; i++) {  // Expect the next minute, see minutePassedDCF77()
+                expectedValue[i] = fieldValue[i];
             }
-
-        } else {
-            currentBit = 0;
-            ERROR = 1;
-            break;
+            predicted = dcf77Prediction;
+            candidateValid = 0;
         }
-        ERROR = 0;
-
-        // set EST time
-        setESTWithDCF77();
-
-        setClock(EST ? (char) estHour : (char) dcf77Hour, (char) dcf77Minute, 0);
-
+        minutePassedDCF77();
+        startFrameDCF77();                  // Start of the next frame
         break;
     case INVALID:
+        frameError = 1;                     // A bit is missing or the second is out of sync
         ERROR = 1;
         break;
     default:
@@ -384,13 +1156,15 @@ void processEventsDCF77(DCF77EVENT event)
 
     if (ERROR == 1) {
         // TURN ON LED B.2
-        PORTB |= 0x04;
+        setLED(0x04);
         // TURN OFF LED B.3
-        PORTB &= ~0x08;
+        clrLED(0x08);
     } else {
         // TURN OFF LED B.2
-        PORTB &= ~0x04;
+        clrLED(0x04);
         // TURN ON LED B.3
-        PORTB |= 0x08;
+        setLED(0x08);
     }
+
+    PROFILE_END(PROFILEDCF77);
 }
@@ -11,11 +11,37 @@
 // Data type for DCF77 signal events
 typedef enum { NODCF77EVENT, VALIDZERO, VALIDONE, VALIDSECOND, VALIDMINUTE, INVALID } DCF77EVENT;
 
-// Global variable holding the last DCF77 event
-extern DCF77EVENT dcf77Event;
+// Flags for multi-frame voting of the received bits and for checking the
+// frames against the expected next minute, for details see dcf77.c
+extern char dcf77Voting;
+extern char dcf77Prediction;
+
+// Flag for acting on the DST changeover and leap second announcements
+extern char dcf77Announcements;
+
+// Flag for the adaptive pulse classifier and confidence of the last pulse
+// classified in percent, set in interrupt context for diagnostics only
+extern char dcf77Adaptive;
+extern unsigned char dcf77Confidence;
 
 // Public functions, for details see dcf77.c
 void initDCF77(void);
 void displayDateDcf77(void);
 DCF77EVENT sampleSignalDCF77(int currentTime);
-void processEventsDCF77(DCF77EVENT event);
+DCF77EVENT edgeSignalDCF77(unsigned long edgeTime, char signal);
+char timeoutDCF77(unsigned long time);
+void processEventsDCF77(DCF77EVENT event, unsigned long eventTime);
+void adaptClassifierDCF77(void);
+
+// Callback function called on every edge of the DCF77 signal in interrupt context,
+// for details see dcf77.c and capture.asm
+void captureDCF77(unsigned int captureTime, char level);
+
+// Glitch filter of the sampled DCF77 signal (DCF77FILTER, see hal.h): length in
+// samples and number of rejected glitches
+extern unsigned char dcf77FilterLength;
+extern unsigned int dcf77Glitches;
+
+// Callback function called for every sample of the DCF77 signal in interrupt
+// context, for details see dcf77.c and sampler.asm
+void filterDCF77(unsigned int sampleTime, char level);
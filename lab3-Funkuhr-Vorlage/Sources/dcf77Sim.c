@@ -12,17 +12,18 @@
     of 8 minutes, then the signals repeat.
 */
 
+#include "hal.h"
 
 long dcf77Data[16] =
 {
-    0x46120000, 0x005C2492,				// DCF77 simulation data        12:31 09.01.2017
-    0x56320000, 0x005C2492,
-    0x56520000, 0x005C2492,
-    0x46720000, 0x005C2492,
-    0x56920000, 0x005C2492,
-    0x46B20000, 0x005C2492,
-    0x46D20000, 0x005C2492,
-    0x56F20000, 0x005C2492
+    0x46140000, 0x005C2492,				// DCF77 simulation data        12:31 09.01.2017
+    0x56340000, 0x005C2492,
+    0x56540000, 0x005C2492,
+    0x46740000, 0x005C2492,
+    0x56940000, 0x005C2492,
+    0x46B40000, 0x005C2492,
+    0x46D40000, 0x005C2492,
+    0x56F40000, 0x005C2492
 };
 int dcf77DataMin = 8;                   // ... for 8 minutes
 
@@ -0,0 +1,80 @@
+/*  Radio signal clock - Event queue between interrupts and main loop
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Single producer / single consumer ring buffer. Events are posted in
+    interrupt context (ticker and input capture ISR, which never interrupt
+    each other) and fetched by the main loop. The producer only writes
+    eventHead, the consumer only writes eventTail. Both are 8 bit, so they
+    are read and written atomically and no interrupt lock is needed.
+*/
+
+#include "events.h"
+
+// Queue size, must be a power of 2
+#define EVENTQUEUESIZE  16
+#define EVENTQUEUEMASK  (EVENTQUEUESIZE - 1)
+
+// Number of events lost, because the queue was full
+unsigned int eventOverflows = 0;
+
+// Modul internal global variables
+static QUEUEDEVENT eventQueue[EVENTQUEUESIZE];
+static volatile unsigned char eventHead = 0;    // Next entry to write, producer only
+static volatile unsigned char eventTail = 0;    // Next entry to read, consumer only
+
+// ****************************************************************************
+//  Initialize event queue module
+//  Called once before interrupts post events
+void initEvents(void)
+{   eventHead = 0;
+    eventTail = 0;
+    eventOverflows = 0;
+}
+
+// ****************************************************************************
+// Post an event into the queue
+// Parameter:   source module, event, time of the event in timer counts
+// Returns:     -
+// Note:        Must only be called in interrupt context. If the queue is full,
+//              the event is dropped and counted in eventOverflows.
+void postEvent(EVENTSOURCE source, unsigned char event, unsigned long time)
+{   unsigned char head = eventHead;
+    unsigned char next = (unsigned char) ((head + 1) & EVENTQUEUEMASK);
+
+    if (next == eventTail)
+    {   eventOverflows++;
+        return;
+    }
+    eventQueue[head].source = (unsigned char) source;
+    eventQueue[head].event  = event;
+    eventQueue[head].time   = time;
+    eventHead = next;                           // Publish the entry after it is complete
+}
+
+// ****************************************************************************
+// Get the oldest event from the queue
+// Parameter:   pointer to the event to fill
+// Returns:     0 if the queue is empty, 1 if an event was returned
+// Note:        Must only be called from the main loop.
+char getEvent(QUEUEDEVENT *event)
+{   unsigned char tail = eventTail;
+
+    if (tail == eventHead)
+        return 0;
+    *event = eventQueue[tail];
+    eventTail = (unsigned char) ((tail + 1) & EVENTQUEUEMASK);   // Release the entry after copying
+    return 1;
+}
+
+// ****************************************************************************
+// Check whether events are waiting in the queue
+// Parameter:   -
+// Returns:     1 if getEvent() would return an event, else 0
+// Note:        Must only be called from the main loop.
+char pendingEvents(void)
+{   return (char) (eventTail != eventHead);
+}
@@ -0,0 +1,27 @@
+/*  Header for event queue module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Modules posting events into the queue
+typedef enum { CLOCKSOURCE, DCF77SOURCE, BUTTONSOURCE } EVENTSOURCE;
+
+// Queued event: source module, event (CLOCKEVENT, DCF77EVENT or button event code) and
+// time of the event in timer counts (see ticker.h)
+typedef struct
+{   unsigned char source;
+    unsigned char event;
+    unsigned long time;
+} QUEUEDEVENT;
+
+// Number of events lost, because the queue was full
+extern unsigned int eventOverflows;
+
+// Public functions, for details see events.c
+void initEvents(void);
+void postEvent(EVENTSOURCE source, unsigned char event, unsigned long time);
+char getEvent(QUEUEDEVENT *event);
+char pendingEvents(void);
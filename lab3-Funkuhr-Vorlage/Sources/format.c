@@ -0,0 +1,68 @@
+/*  Radio signal clock - Fixed width formatting of time and date
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Replaces sprintf() for the LCD output. Every two digit number is copied
+    from a table, so no division is needed at runtime. The output is the same
+    as with the former format strings "%02d:%02d:%02d" and "%s%02d.%02d.%04d%s".
+*/
+
+#include "format.h"
+
+// "00" ... "99", the digits of number n are at index 2*n and 2*n+1
+static const char twoDigits[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+#define PUT2(text, n)   { (text)[0] = twoDigits[2 * (n)]; (text)[1] = twoDigits[2 * (n) + 1]; }
+
+// ****************************************************************************
+// Format a time as "HH:MM:SS"
+// Parameter:   buffer for at least 9 characters, hours, minutes and seconds (0 ... 99)
+// Returns:     -
+void formatTime(char *text, char hours, char minutes, char seconds)
+{   PUT2(text,     hours);
+    text[2] = ':';
+    PUT2(text + 3, minutes);
+    text[5] = ':';
+    PUT2(text + 6, seconds);
+    text[8] = 0;
+}
+
+// ****************************************************************************
+// Format a date as "WwwDD.MM.YYYYzz", e.g. "Mon09.01.2017EU"
+// Parameter:   buffer for at least 16 characters, weekday name (3 characters),
+//              day and month (0 ... 99), year (1900 ... 2199), time zone name (2 characters)
+// Returns:     -
+void formatDate(char *text, const char *weekday, int day, int month, int year, const char *zone)
+{   unsigned char century = 20;
+
+    while (year < 2000)                         // Split the year without a division
+    {   year += 100;
+        century--;
+    }
+    while (year >= 2100)
+    {   year -= 100;
+        century++;
+    }
+    year -= 2000;
+
+    text[0] = weekday[0];
+    text[1] = weekday[1];
+    text[2] = weekday[2];
+    PUT2(text + 3, day);
+    text[5] = '.';
+    PUT2(text + 6, month);
+    text[8] = '.';
+    PUT2(text + 9, century);
+    PUT2(text + 11, year);
+    text[13] = zone[0];
+    text[14] = zone[1];
+    text[15] = 0;
+}
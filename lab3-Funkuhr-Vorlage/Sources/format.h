@@ -0,0 +1,11 @@
+/*  Header for format module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+*/
+
+// Public functions, for details see format.c
+void formatTime(char *text, char hours, char minutes, char seconds);
+void formatDate(char *text, const char *weekday, int day, int month, int year, const char *zone);
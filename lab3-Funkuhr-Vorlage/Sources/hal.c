@@ -0,0 +1,213 @@
+/*  Radio signal clock - Hardware abstraction layer for the HCS12 target
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    All direct register accesses of the C modules are collected here.
+    The host build replaces this file by ../Host/halHost.c.
+*/
+
+#include <hidef.h>                                      // Common defines
+#include <mc9s12dp256.h>                                // CPU specific defines
+
+#include "hal.h"
+
+// EEPROM: mapped to 0x0400 (INITEE after reset), erased and programmed in
+// sectors of 4 bytes with a clock of 150 ... 200kHz
+#define EEPROMWORDS     ((volatile unsigned int *) 0x0400)
+#define EEPROMCLKDIV    20                              // 4MHz quartz / 21 = 190kHz
+#define EEPROMMODIFY    0x60                            // Sector modify command
+
+// ****************************************************************************
+// Initalize the hardware port on which the DCF77 signal is connected as input
+// Parameter:   -
+// Returns:     -
+void initializePort(void)
+{
+#ifdef DCF77CAPTURE
+    // Configure Port T.0 as input capture, one edge armed at a time
+    initCapture();
+#else
+    // Configure Port H.0 as input
+    DDRH &= ~(0x01); // Clear bit 0 of DDRH to set PH0 as input
+    
+    // Enable pull-up resistor on Port H.0 if required
+    PERH |= 0x01;    // Set bit 0 of PERH to enable pull-up resistor on PH0
+
+#ifdef DCF77FILTER
+    // Sample PH0 periodically with ECT channel 6
+    initSampler(DCF77SAMPLEPERIOD);
+#endif
+#endif
+
+    // Configure Port B.0, B.1, B.2, and B.3 as output for LEDs
+    DDRB |= 0x0F;    // Set lower nibble (bits 0-3) of DDRB to configure PB0-PB3 as output
+}
+
+
+// ****************************************************************************
+// Read the hardware port on which the DCF77 signal is connected as input
+// Parameter:   -
+// Returns:     0 if signal is Low, >0 if signal is High
+char readPort(void)
+{
+#ifdef DCF77CAPTURE
+    // Read the value of Port T.0
+    if (PTT & 0x01) {
+#else
+    // Read the value of Port H.0
+    if (PTH & 0x01) {
+#endif
+        return 1; // Signal is High
+    } else {
+        return 0; // Signal is Low
+    }
+}
+
+
+// ****************************************************************************
+// Check whether the DCF77 signal must be polled every 10ms via
+// sampleSignalDCF77(), i.e. the ticker must not sleep longer
+// Parameter:   -
+// Returns:     1 if polled, 0 if the edges are captured or sampled
+char pollingPort(void)
+{
+#if !defined(DCF77CAPTURE) && !defined(DCF77FILTER)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+
+// ****************************************************************************
+// Initialize the push buttons on port H and their key wakeup interrupt
+// Parameter:   -
+// Returns:     -
+void initButtonPort(void)
+{
+    DDRH &= ~BUTTONMASK;    // Buttons as input
+    PPSH &= ~BUTTONMASK;    // Interrupt on the falling edge, buttons are active low
+    PIFH = BUTTONMASK;      // Clear pending interrupts, write 1s
+    PIEH |= BUTTONMASK;     // Enable key wakeup interrupts
+}
+
+
+// ****************************************************************************
+// Read the push buttons
+// Parameter:   -
+// Returns:     bit mask of the buttons currently pressed (1 = pressed)
+// Note:        In the simulator the buttons are active high, remove the ~ there.
+unsigned char readButtons(void)
+{
+    return (unsigned char) (~PTH & BUTTONMASK);
+}
+
+
+// ****************************************************************************
+// Re-enable the key wakeup interrupt of buttons, which have been debounced
+// Parameter:   bit mask of the buttons
+// Returns:     -
+// Note:        Called in interrupt context. The ISR (button.asm) disables the
+//              interrupt of a button when it fires, so bouncing contacts don't
+//              flood the CPU with interrupts.
+void enableButtonIRQ(unsigned char mask)
+{
+    PIFH = mask;            // Discard edges caused by bouncing, write 1s
+    PIEH |= mask;
+}
+
+
+// ****************************************************************************
+// Read the free-running ECT counter (5.33us resolution)
+// Parameter:   -
+// Returns:     TCNT
+unsigned int readTimer(void)
+{
+    return TCNT;
+}
+
+
+// ****************************************************************************
+// Read the current time in the time base of tickerTime and the event
+// timestamps (see ticker.h), e.g. for the latencies of task.c
+// Parameter:   -
+// Returns:     low 16 bit of the time in timer counts, i.e. TCNT
+// Note:        Same as readTimer() on the target, the host build simulates it
+unsigned int nowTimer(void)
+{
+    return TCNT;
+}
+
+
+// ****************************************************************************
+// Disable and enable the interrupts, e.g. around a critical section of the
+// main loop
+// Parameter:   -
+// Returns:     -
+void disableIRQ(void)
+{
+    DisableInterrupts;
+}
+
+void enableIRQ(void)
+{
+    EnableInterrupts;
+}
+
+
+// ****************************************************************************
+// Enable the interrupts and sleep until the next one
+// Parameter:   -
+// Returns:     after the ISR which woke the CPU up
+// Note:        Called with the interrupts disabled. WAI keeps the clocks and
+//              the ECT running (TSWAI is 0), so the ticker, input capture
+//              and key wakeup interrupts end the wait. The CPU12 recognizes
+//              interrupts only one instruction after CLI, so no interrupt
+//              can be taken between CLI and WAI: one pending already, e.g.
+//              posted after the check in idleLoad(), ends WAI at once and
+//              no wakeup is lost.
+void waitIRQ(void)
+{
+    __asm CLI;
+    __asm WAI;
+}
+
+
+// ****************************************************************************
+// Read a word from the EEPROM
+// Parameter:   index of the word, see hal.h
+// Returns:     value, 0xFFFF if erased
+unsigned int readEEPROM(unsigned char index)
+{
+    return EEPROMWORDS[2 * index];          // One word per sector
+}
+
+
+// ****************************************************************************
+// Write a word to the EEPROM
+// Parameter:   index of the word, see hal.h, value
+// Returns:     -
+// Note:        Erases and programs the sector in one command, which blocks
+//              the caller for about 20ms. Must only be called from the main
+//              loop, the EEPROM endures about 100000 writes.
+void writeEEPROM(unsigned char index, unsigned int value)
+{
+    if (EEPROMWORDS[2 * index] == value) {
+        return;                             // Spare the write cycle
+    }
+    if ((ECLKDIV & ECLKDIV_EDIVLD_MASK) == 0) {
+        ECLKDIV = EEPROMCLKDIV;             // Set the clock once after reset
+    }
+    while ((ESTAT & ESTAT_CBEIF_MASK) == 0) {
+    }
+    ESTAT = ESTAT_ACCERR_MASK | ESTAT_PVIOL_MASK;   // Clear old errors, write 1s
+
+    EEPROMWORDS[2 * index] = value;         // Latch address and data ...
+    ECMD = EEPROMMODIFY;                    // ... erase and program the sector
+    ESTAT = ESTAT_CBEIF_MASK;               // Launch the command
+    while ((ESTAT & ESTAT_CCIF_MASK) == 0) {
+    }
+}
@@ -0,0 +1,80 @@
+/*  Header for the hardware abstraction layer
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    The C modules (dcf77.c, clock.c, dcf77Sim.c) only access the hardware
+    through the following interfaces, so they can be built for the HCS12
+    target (hal.c + *.asm) or natively on a PC (see ../Host):
+      - Signal source: DCF77 receiver input, see below
+      - Buttons:       push buttons on port H, see below
+      - LED sink:      led.h    (led.asm on target)
+      - LCD sink:      lcd.h    (lcd.asm on target)
+      - Time source:   ticker.h (ticker.asm on target, calls tick10ms())
+      - EEPROM:        non-volatile words, see below
+*/
+
+// DCF77 signal source
+// On the target, the receiver output is connected to PT0 and each edge is
+// timestamped by ECT input capture channel 0 (capture.asm), no polling needed.
+// The host build and the simulated signal of dcf77Sim.c poll the level every
+// 10ms via sampleSignalDCF77() instead. Without DCF77CAPTURE the target polls
+// the receiver on PH0 as before.
+// With DCF77FILTER instead of DCF77CAPTURE, PH0 is sampled every
+// DCF77SAMPLEPERIOD timer counts by ECT channel 6 (sampler.asm) and glitches
+// are removed by a digital filter (filterDCF77() in dcf77.c) before the edges
+// are evaluated. Define only one of both.
+#ifndef HOST
+#define DCF77CAPTURE
+// #define DCF77FILTER
+#endif
+
+#define DCF77SAMPLEPERIOD   188                 // 1ms, see ticker.h
+
+// Public functions, for details see hal.c
+void initializePort(void);
+char readPort(void);
+char pollingPort(void);
+
+// Free-running ECT counter and current time, for details see hal.c
+unsigned int readTimer(void);
+unsigned int nowTimer(void);
+
+// Interrupt lock and sleep of the main loop, for details see hal.c
+void disableIRQ(void);
+void enableIRQ(void);
+void waitIRQ(void);
+
+// Public functions, for details see capture.asm and sampler.asm
+void initCapture(void);
+void initSampler(unsigned int period);
+
+// Push buttons on PH0 ... PH3 (active low), signalled by the port H key wakeup
+// interrupt. When the DCF77 signal is polled or sampled on PH0, only PH1 ... PH3
+// are used.
+#ifdef DCF77CAPTURE
+#define BUTTONMASK      0x0F
+#else
+#define BUTTONMASK      0x0E
+#endif
+
+// Public functions, for details see hal.c
+void initButtonPort(void);
+unsigned char readButtons(void);
+void enableButtonIRQ(unsigned char mask);
+
+// Non-volatile words in the EEPROM, each in a sector of its own, which survive
+// resets. An erased word reads 0xFFFF.
+#define EEPROMTRIM      0                       // Crystal trim of clock.c ...
+#define EEPROMTRIMCHECK 1                       // ... and its complement
+
+// Public functions, for details see hal.c
+unsigned int readEEPROM(unsigned char index);
+void writeEEPROM(unsigned char index, unsigned int value);
+
+// Prototypes of functions simulation DCF77 signals, when testing without
+// a DCF77 radio signal receiver, for details see dcf77Sim.c
+void initializePortSim(void);                   // Use instead of initializePort() for testing
+char readPortSim(void);                         // Use instead of readPort() for testing
@@ -14,10 +14,13 @@
 ;               JSR initLCD   --> Initialization
 ;                                 (Must be called once)
 ;
-;               JSR writeLine --> Output a zero-termated string to LCD
+;               JSR putLCD    --> Output a character or command to LCD
 ;                                 Parameter:
-;                                 X ... Pointer to string
-;                                 B ... Row number (0 or 1)
+;                                 B ... 7 bit ASCII character, or command with bit 7 set
+;                                 (does not wait for the display, see below)
+;
+;               writeLine() (output of a whole line) is implemented in lcdShadow.c
+;               on top of putLCD.
 ;
 ;               JSR delay_10ms --> 10ms Delay (@24MHz bus clock)
 ;
@@ -46,18 +49,43 @@
 ;   this function calls inidsp1() and inidsp2(), to write the required command sequence. After
 ;   initialization, the display is cleared.
 ;
-;   After initialization, the user program can write strings to both lines of the LCD display
-;   via function writeLine(). Before calling writeLine(), the user program has to copy a
-;   point to the string into register X and the row number (0 or 1) in register B. The string
-;   must be zero terminated.
-;   Both rows of the LCD can display 16 characters. The output will start in the first column
-;   and overwrite the previous output till the end of the row. If the string is longer than
-;   16 characters, only the first 16 will be displayed.
+;   After initialization, the user program can write characters and cursor commands via
+;   function putLCD(). Strings are written with writeLine() of lcdShadow.c, which only
+;   sends the characters which differ from the display contents.
 ;
-;   Note: This driver does not show the cursor and does not provide any functions to move
-;   the cursor or scroll the display horizontally or vertically. For the necessary command
+;   Note: This driver does not show the cursor and does not provide any functions to
+;   scroll the display horizontally or vertically. For the necessary command
 ;   sequences see the LCD's documentation if required.
 ;
+;   Asynchronous output
+;   putLCD() does not talk to the display itself. It puts the character or command
+;   into a queue (lcdQueue) and returns immediately. The queue is emptied by
+;   the interrupt service routine isrECT5 of ECT channel 5 (output compare), which sends
+;   one byte per interrupt and schedules the next interrupt LCDDELAY timer counts (53us)
+;   after the byte has been sent, i.e. after the LCD's execution time of 37us. The
+;   next compare is set from TCNT, not from the previous TC5: isrECT5 may be delayed
+;   by the higher priority interrupts of ECT0 and ECT4, and a compare value already
+;   in the past would only match after the wrap of TCNT (349ms). So a byte takes at
+;   least 53us plus the run time of isrECT5 and its interrupt latency. putLCD() runs
+;   with the interrupts enabled and arms the compare again, if it was interrupted
+;   until the compare value had passed. When the queue is empty, the channel 5
+;   interrupt is disabled; putLCD() enables it again.
+;   Queue entries are 7 bit ASCII characters, entries with bit 7 set are commands
+;   (Set DDRAM address, i.e. cursor position). If the queue is full, entries are dropped
+;   and counted in lcdOverflows.
+;   Worst case run time of isrECT5, a character (counted from the instruction timings
+;   of the CPU12 reference manual): 172 bus cycles, i.e. 7.2us at 24MHz, of which
+;   interrupt entry 9, queue 18, sel_data 17, putByte incl. jsr 89 (with the 1us enable
+;   cycle between the two nibbles), rescheduling TC5 12, run time probe 19, rti 8.
+;   A full line (17 entries) adds 17 x 7.2us = 122us of CPU time, spread over at
+;   least 17 x (53us + 7.2us) = 1.0ms.
+;   The probe measures the ISR from its first to its last TCNT read (142 cycles, 5.9us)
+;   and keeps the maximum in lcdMaxTime (timer counts of 5.33us, see ticker.h). As
+;   the counter is that coarse, a value of 1 or 2 confirms the count, more means the
+;   ISR was stretched, e.g. by wait states.
+;   initLCD() still works synchronously with busy delays, it is called once before the
+;   interrupts run.
+;
 ; -----------------------------------------------------------------------------
 ;   LCD Display of the CodeWarrior debugger's True Time Simulation
 ;   The LCD display of the Dragon 12 Boards can be simulated,if you open the
@@ -80,16 +108,30 @@ SIMULATOR: EQU 1
 ; Otherwise the software will not work as expected.
 
 ; export symbols
-        XDEF initLCD, writeLine, delay_10ms
+        XDEF initLCD, putLCD, delay_10ms, lcdOverflows, lcdMaxTime
 
 ; include derivative specific macros
         INCLUDE 'mc9s12dp256.inc'
 
+LCDQUEUESIZE: equ 64    ; Size of the output queue, must be a power of 2
+
 ; RAM: Variable data section
 .data:  SECTION
 reset_seq:
         ds.b 1
 temp1:  ds.b 1
+lcdQueue:
+        ds.b LCDQUEUESIZE       ; Queue of characters and commands for isrECT5
+lcdHead:
+        ds.b 1                  ; Next entry to write, only written by putLCD
+lcdTail:
+        ds.b 1                  ; Next entry to send, only written by isrECT5
+lcdOverflows:
+        ds.w 1                  ; Number of entries dropped, because the queue was full
+lcdStart:
+        ds.w 1                  ; TCNT at the start of isrECT5
+lcdMaxTime:
+        ds.w 1                  ; Longest run time of isrECT5 in timer counts
 
 ; ROM: Constant data
 .const: SECTION
@@ -138,8 +180,14 @@ REG_SEL:  equ   $01     ; Bit 0 on LCDCTRL: signal RS: 0=reg,    1=data
         ENABLE:   equ   $02     ; Bit 1 on LCDCTRL: signal E:  0=disable 1=enable,
   ENDIF
 
-LCD_LINE0: equ   $80    ; LCD command: set cursor to begin of line 0 (Command Set Display Data RAM Address)
-LCD_LINE1: equ   $C0    ; LCD command: set cursor to begin of line 1 (Command Set Display Data RAM Address)
+LCDQUEUEMASK: equ LCDQUEUESIZE-1
+LCDDELAY:  equ   10     ; Timer counts between two bytes: 10 x 5.33us = 53us
+ONE_US:    equ   4      ; 4 x 250ns = 1us
+TIMER_CH5: equ   $20    ; Bit position for ECT channel 5
+
+.intVect: SECTION
+        ORG $FFE4
+int13:  DC.W isrECT5
 
 ; ROM: Code section
 .init:  SECTION
@@ -186,52 +234,104 @@ inext2:   ldaa 0,x          ; get command
           bne  inext2       ; if not last command, go to get next command
           jsr  delay_5ms    ; delay 5ms
                             ; --- end of command sequence 2 ---
+
+          clr  lcdHead      ; empty output queue
+          clr  lcdTail
+          movw #0, lcdOverflows
+          movw #0, lcdMaxTime
+          bset TIOS, TIMER_CH5  ; channel 5 as output compare, no pin action,
+          bclr TIE, TIMER_CH5   ; ... interrupt enabled by putLCD
           pulx
           puld
           rts
 
 ;**************************************************************
-; Public interface function: writeLine ... Write zero-terminated string to LCD
-; Parameter: X ... pointer to string
-;            B ... row number (0 or 1)
+; Public interface function: putLCD ... Write a character or command to LCD
+; Parameter: B ... 7 bit ASCII character, or command with bit 7 set
+;                  (Set DDRAM address, i.e. cursor position)
 ; Return:    -
-writeLine:
-          pshd
-          pshx
-
-          LDX  6, SP      ; Parameter on stack, not in X
+; Note:      Only queues the output, see "Asynchronous output" above.
+putLCD:   psha
+          tba
+          jsr  lcdPut
+          pula
+          rts
 
-          pshb
-          jsr  sel_inst   ; select instruction
-          pulb
-          cmpb #1
-          beq writeLine1
-writeLine0:
-          ldaa #LCD_LINE0 ; set cursor to begin of line 0
-          bra  wDo
-writeLine1:
-          ldaa #LCD_LINE1 ; set cursor to begin of line 1
-wDo:      jsr  outputByte
-
-          jsr  sel_data   ; select data
-
-msg_out:                  ; output the message character by character
-          ldab #16        ; max. 16 characters
-next:     ldaa 0,x        ; get character
-          beq  eol        ; 0 terminates output
-          decb
-          beq  wEnd       ; not more than 16 characters
-          jsr  outputByte ; write character to LCD
-          inx             ; continue with next character
-          bra  next
-eol:      ldaa #' '       ; fill the rest of the line with blanks
-          jsr  outputByte
-          decb
-          bne  eol
-wEnd:     pulx
+;**************************************************************
+; Internal function: lcdPut ... Put an entry into the output queue
+; and start isrECT5, if it is idle
+; Parameter: A ... character, or command with bit 7 set
+; Return:    -
+lcdPut:   pshb
+          pshx
+          ldab lcdHead
+          ldx  #lcdQueue
+          staa b,x          ; write the entry
+          incb
+          andb #LCDQUEUEMASK
+          cmpb lcdTail
+          beq  putFull      ; queue full, entry is not published
+          stab lcdHead      ; publish the entry
+
+          brset TIE, TIMER_CH5, putEnd  ; isrECT5 already running?
+          pshd
+putArm:   ldd  TCNT         ; ... no, start it
+          addd #LCDDELAY
+          std  TC5
+          movb #TIMER_CH5, TFLG1
+          ldd  TCNT         ; interrupted until the compare has passed?
+          subd TC5
+          bpl  putArm       ; ... yes, its flag is lost, arm it again
+          bset TIE, TIMER_CH5
           puld
+          bra  putEnd
+putFull:  ldx  lcdOverflows
+          inx
+          stx  lcdOverflows
+putEnd:   pulx
+          pulb
           rts
 
+;**************************************************************
+; Internal function: isrECT5 ... Interrupt service routine, sends
+; one entry of the output queue to the LCD
+; Parameter: -
+; Return:    -
+isrECT5:
+          ldd  TCNT         ; start of the run time probe
+          std  lcdStart
+          ldab lcdTail
+          cmpb lcdHead
+          beq  lcdIdle      ; queue empty
+          ldx  #lcdQueue
+          ldaa b,x          ; get entry
+          incb
+          andb #LCDQUEUEMASK
+          stab lcdTail      ; release the entry
+
+          tsta
+          bmi  lcdCmd
+          jsr  sel_data     ; character
+          bra  lcdOut
+lcdCmd:   jsr  sel_inst     ; command
+lcdOut:   jsr  putByte
+
+          ldd  TCNT         ; schedule the next entry, from now, as the
+          addd #LCDDELAY    ; ... interrupt may have been delayed by ECT0/4
+          std  TC5
+          movb #TIMER_CH5, TFLG1
+
+          ldd  TCNT         ; end of the run time probe, keep the maximum
+          subd lcdStart
+          cpd  lcdMaxTime
+          bls  lcdDone
+          std  lcdMaxTime
+lcdDone:  rti
+
+lcdIdle:  bclr TIE, TIMER_CH5  ; nothing to do, stop until putLCD is called
+          movb #TIMER_CH5, TFLG1
+          rti
+
 ;**************************************************************
 ; Public interface function: delay_10ms
 ; Parameter: -
@@ -336,3 +436,42 @@ wrtpls:   pula              ; get the temporarily saved value
           rts
   ENDIF
 
+;**************************************************************
+; Output single byte to LCD display without waiting for the display
+; to execute it (used by isrECT5, which does the pacing)
+; Parameter: a ... byte (data or command) to send to display
+; Return:    -
+  IFDEF  SIMULATOR
+putByte:
+          bset LCDCTRL, ENABLE  ; set E = 1, i.e. write data to LCD
+          staa LCD
+          bclr LCDCTRL, ENABLE  ; set E = 0 again
+          rts
+  ELSE
+putByte:
+          psha              ; save it temporarily
+
+          anda #$f0         ; upper nibble --> A.5...2
+          lsra
+          lsra
+
+          bclr LCD, DATAMASK; output data to PORTK.5..2 without
+          bset LCDCTRL, ENABLE  ; set E = 1, i.e. write data to LCD
+          oraa LCD          ; changing other bits in PORTK
+          staa LCD          ; write data to LCD
+          bclr LCDCTRL, ENABLE  ; set E = 0 again
+          ldx  #ONE_US      ; enable cycle time between the nibbles
+          jsr  del1
+
+          pula              ; get the temporarily saved value
+          anda #$0F         ; lower nibble --> A.5...2
+          lsla
+          lsla
+
+          bclr LCD, DATAMASK; output data to PORTK.5..2 without
+          bset LCDCTRL, ENABLE  ; set E = 1, i.e. write data to LCD
+          oraa LCD          ; changing other bits in PORTK
+          staa LCD          ; write data to LCD
+          bclr LCDCTRL, ENABLE  ; set E = 0 again
+          rts
+  ENDIF
@@ -7,7 +7,21 @@
     Modified: 
 */
 
+// LCD command: set cursor (Command Set Display Data RAM Address), or'ed with the address
+#define LCDSETCURSOR    0x80
+#define LCDLINE0        0x00                    // Address of line 0, column 0
+#define LCDLINE1        0x40                    // Address of line 1, column 0
+
+// Number of characters dropped, because the output queue was full
+extern unsigned int lcdOverflows;
+
+// Longest run time of the output ISR in timer counts, measured by lcd.asm
+extern unsigned int lcdMaxTime;
+
 // Public functions, for details see lcd.asm
 void initLCD(void);
-void writeLine(char* text, unsigned char zeilennummer);
+void putLCD(unsigned char entry);
 void delay_10ms(void);
+
+// Public functions, for details see lcdShadow.c
+void writeLine(char* text, unsigned char zeilennummer);
@@ -0,0 +1,69 @@
+/*  Radio signal clock - Shadow framebuffer of the LCD display
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Keeps a copy of what is physically on the 16x2 display. writeLine()
+    only sends the characters which differ, preceded by a cursor command
+    if they don't follow the previous output directly. A clock update
+    usually changes a single seconds digit, i.e. 2 bytes instead of 17.
+*/
+
+#include "lcd.h"
+
+// Defines
+#define COLUMNS     16
+#define NOCURSOR    0xFF                        // Cursor position not known
+
+// Modul internal global variables
+static char lcdShadow[2][COLUMNS];              // Display contents, 0 = not known
+static unsigned char lcdCursor = NOCURSOR;      // DDRAM address of the cursor
+static unsigned int lcdOverflowsSeen = 0;
+
+// ****************************************************************************
+// Forget the display contents, all characters are sent on the next writeLine()
+// Parameter:   -
+// Returns:     -
+static void invalidateShadow(void)
+{   unsigned char n;
+
+    for (n = 0; n < COLUMNS; n++)
+    {   lcdShadow[0][n] = 0;
+        lcdShadow[1][n] = 0;
+    }
+    lcdCursor = NOCURSOR;
+}
+
+// ****************************************************************************
+// Write a zero-terminated string to a line of the LCD display
+// Parameter:   pointer to the string (max. 16 characters, filled with blanks),
+//              row number (0 or 1)
+// Returns:     -
+void writeLine(char* text, unsigned char zeilennummer)
+{   unsigned char n, address;
+    char c;
+
+    if (zeilennummer > 1)
+        return;
+    if (lcdOverflows != lcdOverflowsSeen)       // Output was lost, display contents unknown
+    {   lcdOverflowsSeen = lcdOverflows;
+        invalidateShadow();
+    }
+
+    address = zeilennummer ? LCDLINE1 : LCDLINE0;
+    for (n = 0; n < COLUMNS; n++, address++)
+    {   c = ' ';
+        if (*text)
+            c = (char) (*text++ & 0x7F);        // Bit 7 marks commands in the LCD queue
+        if (lcdShadow[zeilennummer][n] == c)
+            continue;
+
+        if (lcdCursor != address)
+            putLCD(LCDSETCURSOR | address);
+        putLCD((unsigned char) c);
+        lcdShadow[zeilennummer][n] = c;
+        lcdCursor = (unsigned char) (address + 1);
+    }
+}
@@ -0,0 +1,138 @@
+/*  Radio signal clock - CPU load accounting
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Exactly one section is running at any time. On every switch the timer
+    counts since the last switch are added to the section which ran, so the
+    sections add up to the elapsed time. ISRs never interrupt each other,
+    the main loop switches with the interrupts disabled. The LCD ISR
+    (lcd.asm) does not call back into C, its few microseconds per byte are
+    counted to the section it interrupts. Without CPULOAD (see load.h)
+    only idleLoad() is left.
+*/
+
+#include "hal.h"
+#include "events.h"
+#include "load.h"
+
+#ifdef CPULOAD
+
+#define LOADTICKS   100                         // Publish every 100 ticks, i.e. 1s
+
+// Share of each section and CPU load over the last second in percent
+unsigned char loadShares[NLOADS];
+unsigned char cpuLoad = 0;
+
+// Modul internal global variables
+static unsigned long loadCounts[NLOADS];        // Timer counts of the current second
+static unsigned int loadLast;                   // Counter value at the last switch
+static unsigned char loadCurrent = LOADMAIN;    // Section running now
+static unsigned char loadInterrupted;           // ... and before the ISR
+static int loadTicks = 0;
+
+// ****************************************************************************
+// Add the time since the last switch to the running section and switch
+// Parameter:   section running from now on
+// Returns:     -
+// Note:        Must be called with the interrupts disabled or in an ISR
+static void accountLoad(unsigned char section)
+{   unsigned int now = readTimer();
+
+    loadCounts[loadCurrent] += (unsigned int) (now - loadLast) & 0xFFFF;
+    loadLast = now;
+    loadCurrent = section;
+}
+
+// ****************************************************************************
+//  Initialize CPU load module
+//  Called once before the interrupts are enabled
+void initLoad(void)
+{   unsigned char n;
+
+    for (n = 0; n < NLOADS; n++)
+    {   loadCounts[n] = 0;
+        loadShares[n] = 0;
+    }
+    cpuLoad = 0;
+    loadTicks = 0;
+    loadCurrent = LOADMAIN;
+    loadLast = readTimer();
+}
+
+// ****************************************************************************
+// Switch the section of the main loop
+// Parameter:   section running from now on
+// Returns:     -
+void switchLoad(LOADSECTION section)
+{   disableIRQ();
+    accountLoad((unsigned char) section);
+    enableIRQ();
+}
+
+// ****************************************************************************
+// Begin of an interrupt callback
+// Parameter:   -
+// Returns:     -
+void enterISRLoad(void)
+{   loadInterrupted = loadCurrent;
+    accountLoad(LOADISR);
+}
+
+// ****************************************************************************
+// End of an interrupt callback, the interrupted section continues
+// Parameter:   -
+// Returns:     -
+void leaveISRLoad(void)
+{   accountLoad(loadInterrupted);
+}
+
+// ****************************************************************************
+// Publish the shares once per second, called by tick10ms()
+// Parameter:   10ms ticks since the last call
+// Returns:     -
+void tickLoad(int ticks)
+{   unsigned long total = 0;
+    unsigned char n;
+
+    loadTicks += ticks;
+    if (loadTicks < LOADTICKS)
+        return;
+    loadTicks -= LOADTICKS;
+    accountLoad(loadCurrent);                   // Up to now
+    for (n = 0; n < NLOADS; n++)
+        total += loadCounts[n];
+    if (total == 0)
+        return;
+    for (n = 0; n < NLOADS; n++)
+    {   loadShares[n] = (unsigned char) ((loadCounts[n] * 100 + total / 2) / total);
+        loadCounts[n] = 0;
+    }
+    cpuLoad = (unsigned char) (100 - loadShares[LOADIDLE]);
+}
+
+#endif
+
+// ****************************************************************************
+// Sleep until the next interrupt, if no event is pending
+// Parameter:   -
+// Returns:     -
+// Note:        Called by the main loop when it has nothing left to do. The
+//              queue is checked with the interrupts disabled, so an event
+//              posted after the check wakes the CPU up again. The section
+//              is idle up to the interrupt which ends the sleep and main
+//              after it, until runTasks() switches to the next task.
+void idleLoad(void)
+{   disableIRQ();
+    if (pendingEvents())
+    {   enableIRQ();
+        return;
+    }
+#ifdef CPULOAD
+    accountLoad(LOADIDLE);
+#endif
+    waitIRQ();                                  // Enables the interrupts
+    switchLoad(LOADMAIN);                       // Woken up, back in the main loop
+}
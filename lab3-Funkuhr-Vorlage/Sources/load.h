@@ -0,0 +1,51 @@
+/*  Header for CPU load module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Attributes the run time measured with the free-running ECT counter to
+    the sections below: the main loop switches between its sections with
+    switchLoad() and sleeps in idleLoad(), the interrupt callbacks bracket
+    their work with enterISRLoad() and leaveISRLoad(). Every second the
+    shares are published in percent. The accounting is always on for the
+    target, the host build enables it with -DCPULOAD (make CPULOAD=1), as
+    reading the PC clock slows the simulation down. Without CPULOAD the
+    probes compile to nothing and idleLoad() only sleeps.
+*/
+
+#ifndef HOST
+#define CPULOAD
+#endif
+
+// Sections of the run time
+typedef enum { LOADIDLE, LOADISR, LOADMAIN, LOADCLOCK, LOADDCF77, LOADBUTTONS,
+               LOADDISPLAY, NLOADS } LOADSECTION;
+
+// Sleep of the main loop, for details see load.c
+void idleLoad(void);
+
+#ifdef CPULOAD
+
+// Share of each section and CPU load (100% - idle) over the last second in
+// percent, can be inspected in the debugger
+extern unsigned char loadShares[NLOADS];
+extern unsigned char cpuLoad;
+
+// Public functions, for details see load.c
+void initLoad(void);
+void switchLoad(LOADSECTION section);
+void enterISRLoad(void);
+void leaveISRLoad(void);
+void tickLoad(int ticks);
+
+#else
+
+#define initLoad()
+#define switchLoad(section)
+#define enterISRLoad()
+#define leaveISRLoad()
+#define tickLoad(ticks)
+
+#endif
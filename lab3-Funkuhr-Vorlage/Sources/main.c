@@ -14,41 +14,38 @@
 #include "led.h"
 #include "lcd.h"
 #include "clock.h"
+#include "zone.h"
 #include "dcf77.h"
 #include "ticker.h"
+#include "events.h"
+#include "button.h"
+#include "profile.h"
+#include "load.h"
+#include "task.h"
 
 #pragma LINK_INFO DERIVATIVE "mc9s12dp256b"
 
-void checkButtons(void);
-
 // ****************************************************************************
 void main(void)
-{   
+{
+    initEvents();                               // Initialize event queue
+#ifdef PROFILING
+    initProfile();                              // Initialize run time statistics
+#endif
+    initLoad();                                 // Initialize CPU load accounting
+    initTasks();                                // Initialize the task scheduler
     EnableInterrupts;                           // Allow interrupts
 
     initLED();                                  // Initialize LEDs on port B
     initLCD();                                  // Initialize LCD display
     initClock();                                // Initialize Clock module
     initDCF77();                                // Initialize DCF77 module
+    initButtons();                              // Initialize the buttons
     initTicker();                               // Initialize the time ticker
 
     for(;;)                                     // Endless loop
-    {   
-        if (clockEvent != NOCLOCKEVENT)         // Process clock event
-        {   
-            processEventsClock(clockEvent);
-            displayTimeClock();
-            clockEvent = NOCLOCKEVENT;          // Reset clock event
-        }
-
-        if (dcf77Event != NODCF77EVENT)         // Process DCF77 events
-        {   
-            processEventsDCF77(dcf77Event);
-            displayDateDcf77();
-            dcf77Event = NODCF77EVENT;          // Reset dcf77 event
-        }
-
-        checkButtons();                          // Check the button
+    {   runTasks();                             // Handle all events
+        idleLoad();                             // Sleep until the next interrupt
     }
 }
 
@@ -0,0 +1,63 @@
+/*  Radio signal clock - Run time profiling
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Collects min, max, mean and a log2 histogram of the run time of each
+    probe, see profile.h. The whole module is empty without PROFILING.
+*/
+
+#include "hal.h"
+#include "profile.h"
+
+#ifdef PROFILING
+
+// Statistics of all code sections, can be inspected in the debugger
+PROFILE profiles[NPROFILES];
+
+// ****************************************************************************
+//  Initialize profiling module
+//  Called once before the interrupts are enabled
+void initProfile(void)
+{   unsigned char n, bin;
+
+    for (n = 0; n < NPROFILES; n++)
+    {   profiles[n].min = 0xFFFF;
+        profiles[n].max = 0;
+        profiles[n].sum = 0;
+        profiles[n].count = 0;
+        for (bin = 0; bin < PROFILEBINS; bin++)
+            profiles[n].histogram[bin] = 0;
+    }
+}
+
+// ****************************************************************************
+// End of a measured code section, called via PROFILE_END()
+// Parameter:   probe, counter value at the end of the section
+// Returns:     -
+// Note:        Probes of the main loop may be interrupted by probes of the
+//              ISRs, but each probe must only be used in one context.
+void endProfile(PROFILEPROBE probe, unsigned int end)
+{   PROFILE *profile = &profiles[probe];
+    unsigned int duration = (end - profile->start) & 0xFFFF;
+    unsigned int rest = duration;
+    unsigned char bin = 0;
+
+    if (duration < profile->min)
+        profile->min = duration;
+    if (duration > profile->max)
+        profile->max = duration;
+    profile->sum += duration;
+    profile->count++;
+
+    while (rest != 0 && bin < PROFILEBINS - 1)  // Number of significant bits
+    {   rest >>= 1;
+        bin++;
+    }
+    if (profile->histogram[bin] != 0xFFFF)      // Saturate
+        profile->histogram[bin]++;
+}
+
+#endif
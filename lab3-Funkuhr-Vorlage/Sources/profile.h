@@ -0,0 +1,48 @@
+/*  Header for profiling module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Run time measurement of interrupt callbacks and main loop handlers with
+    the free-running ECT counter. Enable by defining PROFILING (uncomment
+    below, or -DPROFILING for the host build). Without PROFILING, the probes
+    PROFILE_BEGIN() and PROFILE_END() compile to nothing.
+*/
+
+// #define PROFILING
+
+// Measured code sections
+typedef enum { PROFILETICK, PROFILECAPTURE, PROFILEFILTER, PROFILEBUTTONS, PROFILECLOCK,
+               PROFILEDCF77, PROFILEDISPLAYTIME, PROFILEDISPLAYDATE, NPROFILES } PROFILEPROBE;
+
+#ifdef PROFILING
+
+#define PROFILEBINS     16                      // Bin n counts durations of n bits, i.e. < 2^n
+
+// Statistics of a code section, durations in timer counts (target: 5.33us, host: 1ns)
+typedef struct
+{   unsigned int  start;                        // Counter value at PROFILE_BEGIN()
+    unsigned int  min, max;
+    unsigned long sum;                          // mean = sum / count
+    unsigned long count;
+    unsigned int  histogram[PROFILEBINS];
+} PROFILE;
+
+// Statistics of all code sections, can be inspected in the debugger
+extern PROFILE profiles[NPROFILES];
+
+#define PROFILE_BEGIN(probe)    (profiles[probe].start = readTimer())
+#define PROFILE_END(probe)      endProfile(probe, readTimer())
+
+// Public functions, for details see profile.c
+void initProfile(void);
+void endProfile(PROFILEPROBE probe, unsigned int end);
+
+#else
+
+#define PROFILE_BEGIN(probe)
+#define PROFILE_END(probe)
+
+#endif
@@ -0,0 +1,87 @@
+;
+;   Periodic sampling of the DCF77 signal
+;   Uses Enhanced Capture Timer ECT channel 6 (output compare, no pin)
+;
+;   Computerarchitektur 3
+;   (C) 2018 J. Friedrich, W. Zimmermann
+;   Hochschule Esslingen
+;
+;   Modified: -
+;
+;   Usage:
+;               LDD #period
+;               JSR initSampler --> Initialize sampling (must be called once,
+;                                 the timer itself is turned on by initTicker)
+;
+;   Description:
+;   The ISR isrECT6 reads the DCF77 receiver output on PH0 every period timer
+;   counts (5.33us each) and calls the user-provided callback function
+;                       void filterDCF77(unsigned int sampleTime, char level)
+;   with the time of the sample on the stack and the level (0 or 1) in
+;   register B. The callback runs in interrupt context and must be short,
+;   at 1ms it is called 1000 times per second.
+;
+
+; Export symbols
+        XDEF initSampler
+
+; Import symbols
+        XREF filterDCF77        ; External function void filterDCF77(unsigned int, char)
+                                ; called for every sample in interrupt context
+
+; Include derivative specific macros
+        INCLUDE 'mc9s12dp256.inc'
+
+; Defines
+TIMER_CH6   equ $40             ; Bit position for channel 6
+TCTL1_CH6   equ $30             ; Mask corresponds to TCTL1 OM6, OL6
+DCF77_PH0   equ $01             ; Bit position of the DCF77 signal on port H
+
+; RAM: Variable data section
+.data:  SECTION
+samplePeriod: ds.w 1            ; Timer counts between two samples
+
+; ROM: Constant data
+.const: SECTION
+
+.intVect: SECTION
+        ORG $FFE2
+int14:  DC.W isrECT6
+
+
+; ROM: Code section
+.init:  SECTION
+
+;********************************************************************
+; Public interface function: initSampler ... Initialize sampling (called once)
+; Parameter: sample period in timer counts in D
+; Return:    -
+initSampler:
+        std  samplePeriod
+        bclr DDRH,#DCF77_PH0    ; PH0 as input
+        bset TIOS,#TIMER_CH6    ; Set channel 6 in "output compare" mode
+        bclr TCTL1,#TCTL1_CH6   ; ... without pin action
+        addd TCNT               ; First sample one period from now
+        std  TC6
+        movb #TIMER_CH6,TFLG1   ; Discard an old compare event
+        bset TIE,#TIMER_CH6     ; Enable channel 6 interrupt
+        rts
+
+;********************************************************************
+; Internal function: isrECT6 ... Interrupt service routine, called every sample period
+; Parameter: -
+; Return:    -
+isrECT6:
+        ldd  TC6                ; Time of this sample --> 1st parameter on the stack
+        pshd
+        addd samplePeriod       ; Schedule the next sample
+        std  TC6
+        movb #TIMER_CH6,TFLG1   ; Clear the interrupt flag, write a 1 to bit 6
+
+        ldab PTH                ; Level of PH0 --> 2nd parameter in B
+        andb #DCF77_PH0
+
+        jsr  filterDCF77        ; external function called for every sample
+        leas 2,sp               ; Remove the parameter
+
+        rti
@@ -0,0 +1,209 @@
+/*  Radio signal clock - Cooperative task scheduler of the main loop
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Every task has a ring buffer of events, which is only used in the main
+    loop, so no interrupt lock is needed. Before each event handled, the
+    event queue of the interrupts is emptied into the task queues, so an
+    edge of the DCF77 signal waits at most for the one handler running when
+    it arrives and a few instructions of the clock task. The clock runs
+    first, as syncClock() measures the edges against the last second tick
+    processed, so a tick and an edge sampled in the same interrupt are
+    handled in the order they were posted. The display task has the lowest
+    priority but one and merges equal events, so the display is updated once
+    per batch of events as before. The classifier task adapts the pulse
+    lengths of dcf77.c after each minute marker, once the clock is set and
+    shown, so this is not on the way from the marker to the display.
+    The deadline of a task limits the time from the event, i.e. the
+    interrupt which caused it, to the end of its handling. The display task
+    gets the time of the original event passed on, so its deadline covers
+    the whole chain. Latencies are measured in 16 bit, i.e. up to 349ms.
+*/
+
+#include "clock.h"
+#include "zone.h"
+#include "dcf77.h"
+#include "ticker.h"
+#include "hal.h"
+#include "events.h"
+#include "button.h"
+#include "load.h"
+#include "task.h"
+
+// Queue size per task, must be a power of 2
+#define TASKQUEUESIZE   16
+#define TASKQUEUEMASK   (TASKQUEUESIZE - 1)
+
+typedef struct
+{   unsigned char event;
+    unsigned long time;
+} TASKEVENT;
+
+typedef struct
+{   TASKEVENT queue[TASKQUEUESIZE];
+    unsigned char head, tail;
+} TASKQUEUE;
+
+typedef struct
+{   void (*run)(unsigned char event, unsigned long time);
+    unsigned int deadline;                      // In timer counts
+    unsigned char load;                         // LOADSECTION of the CPU load accounting
+    unsigned char merge;                        // 1 if an event already queued is not queued again
+} TASK;
+
+// Statistics of all tasks
+TASKSTATS taskStats[NTASKS];
+
+// Modul internal functions, the tasks
+static void runClock(unsigned char event, unsigned long time);
+static void runDCF77(unsigned char event, unsigned long time);
+static void runButtons(unsigned char event, unsigned long time);
+static void runDisplay(unsigned char event, unsigned long time);
+static void runClassifier(unsigned char event, unsigned long time);
+
+// Task table in the order of TASKID, i.e. of priority
+static const TASK tasks[NTASKS] =
+{   { runClock,      (unsigned int) MSEC2TIMER(20),  LOADCLOCK,   0 },
+    { runDCF77,      (unsigned int) MSEC2TIMER(20),  LOADDCF77,   0 },
+    { runButtons,    (unsigned int) MSEC2TIMER(50),  LOADBUTTONS, 0 },
+    { runDisplay,    (unsigned int) MSEC2TIMER(50),  LOADDISPLAY, 1 },
+    { runClassifier, (unsigned int) MSEC2TIMER(200), LOADDCF77,   1 }
+};
+
+// Task receiving the events of each EVENTSOURCE
+static const unsigned char routes[] = { TASKCLOCK, TASKDCF77, TASKBUTTONS };
+
+// Modul internal global variables
+static TASKQUEUE taskQueues[NTASKS];
+
+// ****************************************************************************
+//  Initialize task scheduler module
+//  Called once before the first runTasks()
+void initTasks(void)
+{   unsigned char n;
+
+    for (n = 0; n < NTASKS; n++)
+    {   taskQueues[n].head = 0;
+        taskQueues[n].tail = 0;
+        taskStats[n].runs = 0;
+        taskStats[n].runTime = 0;
+        taskStats[n].maxRunTime = 0;
+        taskStats[n].maxLatency = 0;
+        taskStats[n].misses = 0;
+        taskStats[n].overflows = 0;
+    }
+}
+
+// ****************************************************************************
+// Queue an event for a task
+// Parameter:   task, event, time of the event in timer counts, i.e. of the
+//              interrupt which caused it
+// Returns:     -
+// Note:        Must only be called from the main loop. If the queue is
+//              full, the event is dropped and counted in taskStats.
+void postTask(TASKID task, unsigned char event, unsigned long time)
+{   TASKQUEUE *q = &taskQueues[task];
+    unsigned char n, next = (unsigned char) ((q->head + 1) & TASKQUEUEMASK);
+
+    if (tasks[task].merge)
+    {   for (n = q->tail; n != q->head; n = (unsigned char) ((n + 1) & TASKQUEUEMASK))
+        {   if (q->queue[n].event == event)     // Keep the earlier time
+                return;
+        }
+    }
+    if (next == q->tail)
+    {   taskStats[task].overflows++;
+        return;
+    }
+    q->queue[q->head].event = event;
+    q->queue[q->head].time  = time;
+    q->head = next;
+}
+
+// ****************************************************************************
+// Run the tasks until all events are handled
+// Parameter:   -
+// Returns:     -
+// Note:        Called by the main loop before it sleeps in idleLoad()
+void runTasks(void)
+{   QUEUEDEVENT irqEvent;
+    TASKEVENT event;
+    TASKQUEUE *q;
+    TASKSTATS *stats;
+    unsigned char n;
+    unsigned int start, runTime, latency;
+
+    for (;;)
+    {   while (getEvent(&irqEvent))             // Route the events of the interrupts
+            postTask((TASKID) routes[irqEvent.source], irqEvent.event, irqEvent.time);
+
+        for (n = 0; n < NTASKS; n++)            // Find the task with the highest priority
+        {   if (taskQueues[n].tail != taskQueues[n].head)
+                break;
+        }
+        if (n == NTASKS)
+            return;
+
+        q = &taskQueues[n];
+        event = q->queue[q->tail];
+        q->tail = (unsigned char) ((q->tail + 1) & TASKQUEUEMASK);
+
+        switchLoad((LOADSECTION) tasks[n].load);
+        start = readTimer();
+        tasks[n].run(event.event, event.time);  // Run to completion
+        runTime = (unsigned int) (readTimer() - start) & 0xFFFF;
+        latency = (unsigned int) (nowTimer() - (unsigned int) event.time) & 0xFFFF;
+        switchLoad(LOADMAIN);
+
+        stats = &taskStats[n];
+        stats->runs++;
+        stats->runTime += runTime;
+        if (runTime > stats->maxRunTime)
+            stats->maxRunTime = runTime;
+        if (latency > stats->maxLatency)
+            stats->maxLatency = latency;
+        if (latency > tasks[n].deadline)
+            stats->misses++;
+    }
+}
+
+// ****************************************************************************
+// The tasks
+// Parameter:   event, time of the event in timer counts
+// Returns:     -
+static void runClock(unsigned char event, unsigned long time)
+{   processEventsClock((CLOCKEVENT) event, time);
+    postTask(TASKDISPLAY, DISPLAYTIME, time);
+}
+
+static void runDCF77(unsigned char event, unsigned long time)
+{   processEventsDCF77((DCF77EVENT) event, time);
+    postTask(TASKDISPLAY, DISPLAYDATE, time);
+    if (event == VALIDMINUTE && dcf77Adaptive)
+        postTask(TASKCLASSIFIER, event, time);
+}
+
+static void runButtons(unsigned char event, unsigned long time)
+{   if (event == BUTTONEVENTCODE(BUTTONPRESSED, 3))  // Button PH3 cycles the zones
+    {   setZoneClock((char) ((zoneClock() + 1) % NZONES));
+        postTask(TASKDISPLAY, DISPLAYTIME, time);
+        postTask(TASKDISPLAY, DISPLAYDATE, time);
+    }
+}
+
+static void runDisplay(unsigned char event, unsigned long time)
+{   (void) time;                                // Only needed for the latency
+    if (event == DISPLAYTIME)
+        displayTimeClock();
+    else
+        displayDateDcf77();
+}
+
+static void runClassifier(unsigned char event, unsigned long time)
+{   (void) event;
+    (void) time;
+    adaptClassifierDCF77();
+}
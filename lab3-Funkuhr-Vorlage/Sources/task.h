@@ -0,0 +1,41 @@
+/*  Header for task scheduler module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Cooperative run-to-completion scheduler of the main loop. Each task has
+    a static priority, a queue of events and a deadline. The events of the
+    interrupts (see events.h) are routed to the tasks by their source, the
+    tasks post events to each other with postTask(). runTasks() always runs
+    the pending task with the highest priority for one event, so the DCF77
+    decoder only waits for the second ticks of the clock, which it measures
+    its edges against, and never for the buttons or the display. The
+    adaptive classifier of the decoder runs last, after the display.
+*/
+
+// Tasks in order of priority, highest first
+typedef enum { TASKCLOCK, TASKDCF77, TASKBUTTONS, TASKDISPLAY, TASKCLASSIFIER, NTASKS } TASKID;
+
+// Events of the display task
+typedef enum { DISPLAYTIME, DISPLAYDATE } DISPLAYEVENT;
+
+// Statistics of a task, can be inspected in the debugger. Run times in
+// readTimer() counts (target: 5.33us, host: 1ns), latencies from the time
+// of the event to the end of its handling in timer counts (see ticker.h).
+typedef struct
+{   unsigned long runs;
+    unsigned long runTime;                      // mean = runTime / runs
+    unsigned int  maxRunTime;
+    unsigned int  maxLatency;
+    unsigned int  misses;                       // Latencies above the deadline
+    unsigned int  overflows;                    // Events lost, because the queue was full
+} TASKSTATS;
+
+extern TASKSTATS taskStats[NTASKS];
+
+// Public functions, for details see task.c
+void initTasks(void);
+void postTask(TASKID task, unsigned char event, unsigned long time);
+void runTasks(void);
@@ -14,31 +14,50 @@
 ;                                 (must be called once)
 ;
 ;   Description:
-;   The timer is initialized in such a way, that the ISR isrECT4 will be called every 10ms.
-;   In the ISR a user-provided callback function
+;   The time is counted in ticks of 10ms, but the ISR isrECT4 is not called on every
+;   tick. Output compare channel 4 is programmed as a one-shot for the next tick on
+;   which work is due. In the ISR a user-provided callback function
 ;                               void tick10ms(void)
-;   will be called. This function must end before the next timer interrupt event, i.e.
-;   the callbacks run time must be less than 10ms!
+;   will be called, which handles all ticks since the last call and sets
+;                               int tickerTicks   (ticks up to the next call, 1 ... 16)
+;                               int tickerAdjust  (timer counts, signed)
+;   The ISR then programs TC4 for tickerTicks ticks plus tickerAdjust counts later,
+;   e.g. to shift the phase of the clock. The callbacks run time must be less than
+;   10ms!
+;   Before calling the callback, the ISR updates the time base
+;                               unsigned long tickerTime  (time of the tick, 32 bit)
+;                               unsigned int  tickerTC    (time of the tick, value of TC4)
+;   which allows other ECT channels to extend their 16 bit timestamps to 32 bit.
+;   tickerTime follows TC4 in any case.
+;   An ISR (or the main loop with the interrupts disabled) which needs the callback
+;   sooner, e.g. for a button, calls
+;                               void wakeTicker(void)
+;   which moves the interrupt to the next tick after now, if that is earlier.
 ;
 
 ; Export symbols
-        XDEF initTicker
+        XDEF initTicker, wakeTicker, tickerTime, tickerTC, tickerTicks, tickerAdjust
 
 ; Import symbols
         XREF tick10ms           ; External function void tick10ms(void) called
-                                ; every 10ms in interrupt context
+                                ; in interrupt context
 
 ; Include derivative specific macros
         INCLUDE 'mc9s12dp256.inc'
 
 ; Defines
 TENMS       equ 1875            ; 10 ms
+WAKEMARGIN  equ 4               ; Min. timer counts from now to a moved interrupt
 TIMER_ON    equ $80             ; tscr1 value to turn ECT on
 TIMER_CH4   equ $10             ; Bit position for channel 4
 TCTL1_CH4   equ $03             ; Mask corresponds to TCTL1 OM4, OL4
 
 ; RAM: Variable data section
 .data:  SECTION
+tickerTime: ds.l 1              ; Time base in timer counts, incremented by the period every tick
+tickerTC:   ds.w 1              ; TC4 value of the last tick
+tickerTicks: ds.w 1             ; Ticks up to the next interrupt, set by tick10ms
+tickerAdjust: ds.w 1            ; Timer counts added to the next period, set by tick10ms
 
 ; ROM: Constant data
 .const: SECTION
@@ -58,6 +77,8 @@ int12:  DC.W isrECT4
 initTicker:
 ;       JSR  pllInit            ; Initalize PLL generator (not really necessary with serial monitor)
 
+        movw #1,tickerTicks     ; First period: one tick
+        movw #0,tickerAdjust
         ldab #TIMER_ON          ; Timer master ON switch
         stab TSCR1
         bset TIOS,#TIMER_CH4    ; Set channel 4 in "output compare" mode
@@ -79,18 +100,63 @@ initTicker:
         rts
 
 ;********************************************************************
-; Internal function: isrECT4 ... Interrupt service routine, called by the timer ticker every 10ms
+; Public interface function: wakeTicker ... Call tick10ms() on the next tick after now
+; Parameter: -
+; Return:    -
+; Note:      Called in interrupt context or with the interrupts disabled, i.e. not
+;            interrupted by isrECT4. If the interrupt is due anyway, it is not moved.
+wakeTicker:
+        ldd  TCNT               ; Counts from the last interrupt to now (+ margin) ...
+        addd #WAKEMARGIN
+        subd tickerTC
+        subd tickerAdjust       ; ... without the adjustment of this period
+        bpl  wakePositive
+        ldd  #0
+wakePositive:
+        ldx  #TENMS
+        idiv                    ; X = whole ticks up to now
+        inx                     ; ... the next tick after now
+        cpx  tickerTicks
+        bhs  wakeDone           ; Not earlier than programmed
+        stx  tickerTicks
+        tfr  x,d                ; TC4 = tickerTC + ticks * TENMS + tickerAdjust
+        ldy  #TENMS
+        emul
+        addd tickerAdjust
+        addd tickerTC
+        std  TC4
+wakeDone:
+        rts
+
+;********************************************************************
+; Internal function: isrECT4 ... Interrupt service routine, called on the ticks where
+; tick10ms() has work to do
 ; Parameter: -
 ; Return:    -
 isrECT4:
-        ldd  TC4                ; Schedule the next ISR period
-        addd #TENMS
+        ldx  TC4                ; Time of this tick
+        tfr  x,d
+        subd tickerTC           ; ... minus time of the last one is the period
+        stx  tickerTC           ; Remember the time of this tick
+
+        addd tickerTime+2       ; tickerTime += period (32 bit, big endian)
+        std  tickerTime+2
+        bcc  noCarry
+        ldx  tickerTime
+        inx
+        stx  tickerTime
+noCarry:
+        jsr  tick10ms           ; external function, sets tickerTicks and tickerAdjust
+
+        ldd  tickerTicks        ; Schedule the next interrupt
+        ldy  #TENMS
+        emul                    ; D = ticks * TENMS (max. 16 ticks, fits 16 bit)
+        addd tickerAdjust       ; ... lengthened or shortened
+        addd tickerTC
         std  TC4
         ldab #TIMER_CH4         ; Clear the interrupt flag, write a 1 to bit 4
         stab TFLG1
 
-        jsr  tick10ms           ; external function called every 10ms
-
 notYet: rti
 
 ;********************************************************************
@@ -8,5 +8,35 @@
 
 */
 
+// ECT timer: 24MHz bus clock / prescaler 128 = 187500 Hz, i.e. 5.33us resolution
+#define TIMERHZ         187500L
+#define TIMER10MS       1875                                // Timer counts per ticker period
+#define MSEC2TIMER(ms)  ((unsigned long) (ms) * 375 / 2)    // Milliseconds to timer counts
+
+// Longest ticker period in ticks. Other ECT channels extend their 16 bit
+// timestamps with the signed difference to tickerTC, so the time base must
+// be updated at least every 32767 timer counts (174ms), see dcf77.c
+#define MAXTICKERTICKS  16
+
+// Time base of the ticker, updated by every ticker interrupt
+extern unsigned long tickerTime;                // Time of the last interrupt in timer counts, 32 bit
+extern unsigned int  tickerTC;                  // ... same as value of the 16 bit ECT counter
+
+// Period up to the next ticker interrupt, set by tick10ms(): a number of
+// 10ms ticks (1 ... MAXTICKERTICKS) and timer counts added to shift the
+// phase of the ticker (see clock.c). wakeTicker() may shorten tickerTicks.
+extern int tickerTicks;
+extern int tickerAdjust;
+
 // Public functions, for details see ticker.asm
 void initTicker(void);
+void wakeTicker(void);
+
+// Request a ticker interrupt at a time in timer counts at the latest, called
+// in interrupt context, e.g. by the buttons and the DCF77 signal timeout,
+// for details see clock.c
+void deadlineTicker(unsigned long time);
+
+// Callback function called in interrupt context on the ticks with work to do,
+// for details see clock.c
+void tick10ms(void);
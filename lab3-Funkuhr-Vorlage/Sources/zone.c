@@ -0,0 +1,135 @@
+/*  Radio signal clock - Time zones and daylight saving time
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Table of time zones with their offset to UTC and daylight saving time
+    (DST) rule, both in ROM. A rule switches to DST on the n-th or last
+    Sunday of one month and back on the n-th or last Sunday of another
+    month, at a full hour of UTC (EU) or of the local standard time (US,
+    Australia). All transitions of the table fall on full hours of UTC, so
+    the clock module only needs to evaluate the rule once per hour, see
+    updateZoneClock() in clock.c.
+*/
+
+#include "clock.h"
+#include "zone.h"
+
+// DST rules
+enum { NODST, EURULE, USRULE, AURULE };
+
+#define LASTWEEK    5                           // Last Sunday of the month
+
+typedef struct
+{   char month;                                 // 1 ... 12
+    char week;                                  // 1 = first Sunday ... 4, LASTWEEK
+    char hour;                                  // UTC or local standard time, see DSTRULE
+} TRANSITION;
+
+typedef struct
+{   TRANSITION start, end;
+    char utc;                                   // Hours are UTC, else local standard time
+} DSTRULE;
+
+typedef struct
+{   char name[3];                               // Shown on the LCD
+    int offset;                                 // Standard time to UTC in minutes
+    char rule;
+} ZONE;
+
+static const DSTRULE rules[] =
+{   { {  0, 0,        0 }, {  0, 0,        0 }, 0 },    // NODST, not used
+    { {  3, LASTWEEK, 1 }, { 10, LASTWEEK, 1 }, 1 },    // EU: 01:00 UTC
+    { {  3, 2,        2 }, { 11, 1,        1 }, 0 },    // US: 02:00 local time (01:00 standard)
+    { { 10, 1,        2 }, {  4, 1,        2 }, 0 },    // AU: 02:00 ... 03:00 local time (02:00 standard)
+};
+
+static const ZONE zones[NZONES] =
+{   { "UT",    0, NODST  },                     // UTC
+    { "UK",    0, EURULE },                     // London, GMT/BST
+    { "EU",   60, EURULE },                     // Berlin, CET/CEST, ZONEDCF77
+    { "EE",  120, EURULE },                     // Helsinki, EET/EEST
+    { "US", -300, USRULE },                     // New York, EST/EDT
+    { "UC", -360, USRULE },                     // Chicago, CST/CDT
+    { "UM", -420, USRULE },                     // Denver, MST/MDT
+    { "UP", -480, USRULE },                     // Los Angeles, PST/PDT
+    { "IN",  330, NODST  },                     // India, IST
+    { "JP",  540, NODST  },                     // Japan, JST
+    { "AU",  600, AURULE },                     // Sydney, AEST/AEDT
+};
+
+static const char monthLength[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+static const int monthStart[13] = { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+// ****************************************************************************
+// internal function: transitionZone ... Time of a DST transition
+// Parameter:   transition, zone, any date of the year
+// Returns:     local standard time in minutes since the start of the year
+static long transitionZone(const TRANSITION *t, const ZONE *z, const CLOCKDATE *date)
+{   int first, sunday, length;
+
+    // Day of the year of the 1st of the month and of its first Sunday,
+    // from the weekday of the given date
+    first = monthStart[(int) t->month] + 1 + (t->month > 2 && date->leapYear);
+    sunday = first + 6 - (date->weekday - 1 + (first - date->yearDay) % 7 + 7) % 7;
+    if (t->week == LASTWEEK)
+    {   length = monthLength[(int) t->month] + (t->month == 2 && date->leapYear);
+        sunday += sunday + 28 < first + length ? 28 : 21;
+    } else
+    {   sunday += 7 * (t->week - 1);
+    }
+    return (sunday - 1) * 1440L + t->hour * 60 + (rules[(int) z->rule].utc ? z->offset : 0);
+}
+
+// ****************************************************************************
+// internal function: summerZone ... Check if DST is in effect
+// Parameter:   zone, date and local standard time in minutes since the start
+//              of the year, may be before or after the day of the date
+// Returns:     1 for DST, else 0
+static char summerZone(const ZONE *z, const CLOCKDATE *date, long minute)
+{   const DSTRULE *r = &rules[(int) z->rule];
+    long start, end;
+
+    if (z->rule == NODST)
+        return 0;
+    start = transitionZone(&r->start, z, date);
+    end = transitionZone(&r->end, z, date);
+    if (start < end)                            // Northern hemisphere
+        return (char) (minute >= start && minute < end);
+    return (char) (minute >= start || minute < end);    // Southern, DST over New Year
+}
+
+// ****************************************************************************
+// Offset of a zone to UTC at a point of time given in UTC
+// Parameter:   zone 0 ... NZONES-1, date and full hour in UTC
+// Returns:     offset in minutes, including DST
+int offsetZone(char zone, const CLOCKDATE *date, char hour)
+{   const ZONE *z = &zones[(int) zone];
+    long minute = (date->yearDay - 1) * 1440L + hour * 60 + z->offset;
+
+    return z->offset + (summerZone(z, date, minute) ? 60 : 0);
+}
+
+// ****************************************************************************
+// Offset of a zone to UTC at a point of time given in the local time of
+// the zone, e.g. the DCF77 time
+// Parameter:   zone 0 ... NZONES-1, local date and full hour
+// Returns:     offset in minutes, including DST
+// Note:        The hour repeated when DST ends is taken as DST, the hour
+//              skipped when it starts as standard time.
+int localOffsetZone(char zone, const CLOCKDATE *date, char hour)
+{   const ZONE *z = &zones[(int) zone];
+    long minute = (date->yearDay - 1) * 1440L + hour * 60 - 60;
+
+    return z->offset + (summerZone(z, date, minute) ? 60 : 0);
+}
+
+// ****************************************************************************
+// Name of a zone for the LCD
+// Parameter:   zone 0 ... NZONES-1
+// Returns:     two characters
+const char *nameZone(char zone)
+{   return zones[(int) zone].name;
+}
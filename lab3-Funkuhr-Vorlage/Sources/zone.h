@@ -0,0 +1,18 @@
+/*  Header for time zone module
+
+    Computerarchitektur 3
+    (C) 2018 J. Friedrich, W. Zimmermann Hochschule Esslingen
+
+    Modified: -
+
+    Uses CLOCKDATE, include clock.h first.
+*/
+
+// Time zones in the table of zone.c
+#define NZONES      11
+#define ZONEDCF77   2                           // Zone of the DCF77 time, CET/CEST
+
+// Public functions, for details see zone.c
+int offsetZone(char zone, const CLOCKDATE *date, char hour);
+int localOffsetZone(char zone, const CLOCKDATE *date, char hour);
+const char *nameZone(char zone);